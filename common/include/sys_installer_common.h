@@ -17,6 +17,7 @@
 #define SYS_INSTALLER_COMMON_H
 
 #include <string>
+#include <cstdint>
 #include <cstdlib>
 #include <cstdio>
 #include <cstring>
@@ -29,6 +30,15 @@ constexpr const char *SYS_LOG_FILE = "/data/updater/log/sys_installer.log";
 constexpr const char *SYS_STAGE_FILE = "/data/updater/log/sys_installer_stage.log";
 constexpr const char *SYS_ERROR_FILE = "/data/updater/log/sys_installer_error_code.log";
 
+// stream session geometry, shared by the client shared memory ring and the service chunk pool
+constexpr uint32_t STREAM_DEFAULT_SLOT_SIZE = 50 * 1024;
+constexpr uint32_t STREAM_DEFAULT_SLOT_NUM = 2;
+constexpr uint32_t STREAM_MIN_SLOT_SIZE = 4 * 1024;
+constexpr uint32_t STREAM_MAX_SLOT_SIZE = 4 * 1024 * 1024;
+constexpr uint32_t STREAM_MIN_SLOT_NUM = 2;
+constexpr uint32_t STREAM_MAX_SLOT_NUM = 64;
+constexpr uint64_t STREAM_MAX_RING_SIZE = 64 * 1024 * 1024;
+
 enum InstallerErrCode {
     SYS_UPDATE_SUCCESS = 0,
     SYS_PKG_NOT_EXIST,
@@ -16,6 +16,7 @@
 #ifndef STREAM_INSTALLER_MANAGER_H
 #define STREAM_INSTALLER_MANAGER_H
 
+#include "ashmem.h"
 #include "stream_installer_manager_helper.h"
 #include "macros_updater.h"
 #include "stream_status_manager.h"
@@ -31,7 +32,18 @@ public:
     virtual int32_t SysInstallerInit();
     virtual int32_t StartStreamUpdate();
     virtual int32_t StopStreamUpdate();
+    virtual int32_t ResumeStreamUpdate(uint64_t &offset);
     virtual int32_t ProcessStreamData(const uint8_t *buffer, uint32_t size);
+    virtual int32_t RegisterSharedMemory(const sptr<Ashmem> &ashmem, uint32_t slotSize, uint32_t slotNum);
+    virtual int32_t ProcessSharedStreamData(uint32_t slotIndex, uint32_t size);
+    virtual int32_t TryProcessStreamData(const uint8_t *buffer, uint32_t size, StreamPushResult &pushResult,
+        uint32_t &credits);
+    virtual int32_t TryProcessSharedStreamData(uint32_t slotIndex, uint32_t size, StreamPushResult &pushResult,
+        uint32_t &credits);
+    virtual int32_t ProcessStreamDataBatch(const uint8_t *buffer, uint32_t size, uint32_t &acceptedSize);
+    virtual int32_t ProcessSharedStreamDataBatch(uint32_t size, uint32_t &acceptedSize);
+    virtual int32_t SetSessionConfig(const StreamSessionConfig &config);
+    virtual int32_t GetStreamUpdateStats(StreamUpdateStats &stats);
     virtual int32_t SetUpdateCallback(const sptr<ISysInstallerCallback> &updateCallback);
     virtual int32_t GetUpdateStatus();
 
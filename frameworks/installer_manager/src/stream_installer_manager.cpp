@@ -63,6 +63,15 @@ int32_t StreamInstallerManager::StopStreamUpdate()
     return helper_->StopStreamUpdate();
 }
 
+int32_t StreamInstallerManager::ResumeStreamUpdate(uint64_t &offset)
+{
+    if (helper_ == nullptr) {
+        LOG(ERROR) << "helper_ null";
+        return -1;
+    }
+    return helper_->ResumeStreamUpdate(offset);
+}
+
 int32_t StreamInstallerManager::ProcessStreamData(const uint8_t *buffer, uint32_t size)
 {
     if (helper_ == nullptr) {
@@ -72,6 +81,82 @@ int32_t StreamInstallerManager::ProcessStreamData(const uint8_t *buffer, uint32_
     return helper_->ProcessStreamData(buffer, size);
 }
 
+int32_t StreamInstallerManager::RegisterSharedMemory(const sptr<Ashmem> &ashmem, uint32_t slotSize,
+    uint32_t slotNum)
+{
+    if (helper_ == nullptr) {
+        LOG(ERROR) << "helper_ null";
+        return -1;
+    }
+    return helper_->RegisterSharedMemory(ashmem, slotSize, slotNum);
+}
+
+int32_t StreamInstallerManager::ProcessSharedStreamData(uint32_t slotIndex, uint32_t size)
+{
+    if (helper_ == nullptr) {
+        LOG(ERROR) << "helper_ null";
+        return -1;
+    }
+    return helper_->ProcessSharedStreamData(slotIndex, size);
+}
+
+int32_t StreamInstallerManager::TryProcessStreamData(const uint8_t *buffer, uint32_t size,
+    StreamPushResult &pushResult, uint32_t &credits)
+{
+    if (helper_ == nullptr) {
+        LOG(ERROR) << "helper_ null";
+        return -1;
+    }
+    return helper_->TryProcessStreamData(buffer, size, pushResult, credits);
+}
+
+int32_t StreamInstallerManager::TryProcessSharedStreamData(uint32_t slotIndex, uint32_t size,
+    StreamPushResult &pushResult, uint32_t &credits)
+{
+    if (helper_ == nullptr) {
+        LOG(ERROR) << "helper_ null";
+        return -1;
+    }
+    return helper_->TryProcessSharedStreamData(slotIndex, size, pushResult, credits);
+}
+
+int32_t StreamInstallerManager::ProcessStreamDataBatch(const uint8_t *buffer, uint32_t size,
+    uint32_t &acceptedSize)
+{
+    if (helper_ == nullptr) {
+        LOG(ERROR) << "helper_ null";
+        return -1;
+    }
+    return helper_->ProcessStreamDataBatch(buffer, size, acceptedSize);
+}
+
+int32_t StreamInstallerManager::ProcessSharedStreamDataBatch(uint32_t size, uint32_t &acceptedSize)
+{
+    if (helper_ == nullptr) {
+        LOG(ERROR) << "helper_ null";
+        return -1;
+    }
+    return helper_->ProcessSharedStreamDataBatch(size, acceptedSize);
+}
+
+int32_t StreamInstallerManager::SetSessionConfig(const StreamSessionConfig &config)
+{
+    if (helper_ == nullptr) {
+        LOG(ERROR) << "helper_ null";
+        return -1;
+    }
+    return helper_->SetSessionConfig(config);
+}
+
+int32_t StreamInstallerManager::GetStreamUpdateStats(StreamUpdateStats &stats)
+{
+    if (helper_ == nullptr) {
+        LOG(ERROR) << "helper_ null";
+        return -1;
+    }
+    return helper_->GetStreamUpdateStats(stats);
+}
+
 int32_t StreamInstallerManager::SetUpdateCallback(const sptr<ISysInstallerCallback> &updateCallback)
 {
     if (helper_ == nullptr) {
@@ -33,6 +33,8 @@ int32_t StreamInstallerManagerHelper::SysInstallerInit()
     }
     statusManager_->Init();
     StreamInstallProcesser::GetInstance().SetStatusManager(statusManager_);
+    StreamInstallProcesser::GetInstance().ReleaseSharedMemory();
+    (void)StreamInstallProcesser::GetInstance().SetSessionConfig(STREAM_DEFAULT_SLOT_SIZE, STREAM_DEFAULT_SLOT_NUM);
 
     return 0;
 }
@@ -70,11 +72,78 @@ int32_t StreamInstallerManagerHelper::StopStreamUpdate()
     return 0;
 }
 
+int32_t StreamInstallerManagerHelper::ResumeStreamUpdate(uint64_t &offset)
+{
+    LOG(INFO) << "ResumeStreamUpdate start";
+    if (statusManager_ == nullptr) {
+        LOG(ERROR) << "statusManager_ nullptr";
+        return -1;
+    }
+    if (StreamInstallProcesser::GetInstance().IsRunning()) {
+        LOG(ERROR) << "StreamInstallProcesser IsRunning";
+        return -1;
+    }
+    if (StreamInstallProcesser::GetInstance().Resume(offset) == -1) {
+        LOG(ERROR) << "StreamInstallProcesser resume fail";
+        return -1;
+    }
+    return 0;
+}
+
 int32_t StreamInstallerManagerHelper::ProcessStreamData(const uint8_t *buffer, uint32_t size)
 {
     return StreamInstallProcesser::GetInstance().ProcessStreamData(buffer, size);
 }
 
+int32_t StreamInstallerManagerHelper::RegisterSharedMemory(const sptr<Ashmem> &ashmem, uint32_t slotSize,
+    uint32_t slotNum)
+{
+    return StreamInstallProcesser::GetInstance().SetSharedMemory(ashmem, slotSize, slotNum);
+}
+
+int32_t StreamInstallerManagerHelper::ProcessSharedStreamData(uint32_t slotIndex, uint32_t size)
+{
+    return StreamInstallProcesser::GetInstance().ProcessSharedStreamData(slotIndex, size);
+}
+
+int32_t StreamInstallerManagerHelper::TryProcessStreamData(const uint8_t *buffer, uint32_t size,
+    StreamPushResult &pushResult, uint32_t &credits)
+{
+    return StreamInstallProcesser::GetInstance().TryProcessStreamData(buffer, size, pushResult, credits);
+}
+
+int32_t StreamInstallerManagerHelper::TryProcessSharedStreamData(uint32_t slotIndex, uint32_t size,
+    StreamPushResult &pushResult, uint32_t &credits)
+{
+    return StreamInstallProcesser::GetInstance().TryProcessSharedStreamData(slotIndex, size, pushResult, credits);
+}
+
+int32_t StreamInstallerManagerHelper::ProcessStreamDataBatch(const uint8_t *buffer, uint32_t size,
+    uint32_t &acceptedSize)
+{
+    return StreamInstallProcesser::GetInstance().ProcessStreamDataBatch(buffer, size, acceptedSize);
+}
+
+int32_t StreamInstallerManagerHelper::ProcessSharedStreamDataBatch(uint32_t size, uint32_t &acceptedSize)
+{
+    return StreamInstallProcesser::GetInstance().ProcessSharedStreamDataBatch(size, acceptedSize);
+}
+
+int32_t StreamInstallerManagerHelper::SetSessionConfig(const StreamSessionConfig &config)
+{
+    if (StreamInstallProcesser::GetInstance().IsRunning()) {
+        LOG(ERROR) << "StreamInstallProcesser IsRunning, config can not be changed";
+        return -1;
+    }
+    return StreamInstallProcesser::GetInstance().SetSessionConfig(config.slotSize, config.slotNum);
+}
+
+int32_t StreamInstallerManagerHelper::GetStreamUpdateStats(StreamUpdateStats &stats)
+{
+    StreamInstallProcesser::GetInstance().GetStats(stats);
+    return 0;
+}
+
 int32_t StreamInstallerManagerHelper::SetUpdateCallback(const sptr<ISysInstallerCallback> &updateCallback)
 {
     if (statusManager_ == nullptr) {
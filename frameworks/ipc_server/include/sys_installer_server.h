@@ -74,7 +74,18 @@ public:
     int32_t StartUpdatePackageZip(const std::string &taskId, const std::string &pkgPath) override;
     int32_t StartStreamUpdate() override;
     int32_t StopStreamUpdate() override;
+    int32_t ResumeStreamUpdate(uint64_t &offset) override;
     int32_t ProcessStreamData(const BufferInfoParcel &bufferParcel) override;
+    int32_t RegisterStreamSharedMemory(const StreamShmParcel &shmParcel) override;
+    int32_t ProcessStreamSharedData(uint32_t slotIndex, uint32_t size) override;
+    int32_t TryProcessStreamData(const BufferInfoParcel &bufferParcel, StreamPushResult &pushResult,
+        uint32_t &credits) override;
+    int32_t TryProcessStreamSharedData(uint32_t slotIndex, uint32_t size, StreamPushResult &pushResult,
+        uint32_t &credits) override;
+    int32_t ProcessStreamDataBatch(const BufferListParcel &bufferListParcel, uint32_t &acceptedSize) override;
+    int32_t ProcessStreamSharedDataBatch(uint32_t size, uint32_t &acceptedSize) override;
+    int32_t SetStreamSessionConfig(const StreamSessionConfig &config) override;
+    int32_t GetStreamUpdateStats(StreamUpdateStats &stats) override;
     int32_t SetUpdateCallback(const std::string &taskId, const sptr<ISysInstallerCallback> &updateCallback) override;
     int32_t GetUpdateStatus(const std::string &taskId) override;
     int32_t StartUpdateParaZip(const std::string &taskId, const std::string &pkgPath,
@@ -116,7 +127,7 @@ public:
     int32_t GetPartitionStashSize(const std::string &taskId, const std::vector<std::string> &pkgPaths,
         uint64_t &stashSize) override;
 
-    bool CheckCallingPerm(void);
+    bool CheckCallingPerm(bool isQuiet = false);
     bool IsPermissionGranted(void);
     int32_t CallbackEnter([[maybe_unused]] uint32_t code) override;
     int32_t CallbackExit([[maybe_unused]] uint32_t code, [[maybe_unused]] int32_t result) override;
@@ -113,14 +113,86 @@ int32_t SysInstallerServer::StopStreamUpdate()
     return StreamInstallerManager::GetInstance().StopStreamUpdate();
 }
 
+int32_t SysInstallerServer::ResumeStreamUpdate(uint64_t &offset)
+{
+    LOG(INFO) << "ResumeStreamUpdate";
+    DEFINE_EXIT_GUARD();
+    return StreamInstallerManager::GetInstance().ResumeStreamUpdate(offset);
+}
+
 int32_t SysInstallerServer::ProcessStreamData(const BufferInfoParcel &bufferParcel)
 {
-    LOG(INFO) << "ProcessStreamData";
     DEFINE_EXIT_GUARD();
     return StreamInstallerManager::GetInstance().ProcessStreamData(bufferParcel.bufferInfo.buffer,
         bufferParcel.bufferInfo.size);
 }
 
+int32_t SysInstallerServer::RegisterStreamSharedMemory(const StreamShmParcel &shmParcel)
+{
+    LOG(INFO) << "RegisterStreamSharedMemory";
+    DEFINE_EXIT_GUARD();
+    return StreamInstallerManager::GetInstance().RegisterSharedMemory(shmParcel.shmInfo.ashmem,
+        shmParcel.shmInfo.slotSize, shmParcel.shmInfo.slotNum);
+}
+
+int32_t SysInstallerServer::ProcessStreamSharedData(uint32_t slotIndex, uint32_t size)
+{
+    DEFINE_EXIT_GUARD();
+    return StreamInstallerManager::GetInstance().ProcessSharedStreamData(slotIndex, size);
+}
+
+int32_t SysInstallerServer::TryProcessStreamData(const BufferInfoParcel &bufferParcel, StreamPushResult &pushResult,
+    uint32_t &credits)
+{
+    DEFINE_EXIT_GUARD();
+    return StreamInstallerManager::GetInstance().TryProcessStreamData(bufferParcel.bufferInfo.buffer,
+        bufferParcel.bufferInfo.size, pushResult, credits);
+}
+
+int32_t SysInstallerServer::TryProcessStreamSharedData(uint32_t slotIndex, uint32_t size,
+    StreamPushResult &pushResult, uint32_t &credits)
+{
+    DEFINE_EXIT_GUARD();
+    return StreamInstallerManager::GetInstance().TryProcessSharedStreamData(slotIndex, size, pushResult, credits);
+}
+
+int32_t SysInstallerServer::ProcessStreamDataBatch(const BufferListParcel &bufferListParcel, uint32_t &acceptedSize)
+{
+    DEFINE_EXIT_GUARD();
+    acceptedSize = 0;
+    for (const auto &bufferInfo : bufferListParcel.bufferInfos) {
+        uint32_t bufferAccepted = 0;
+        int32_t ret = StreamInstallerManager::GetInstance().ProcessStreamDataBatch(bufferInfo.buffer,
+            bufferInfo.size, bufferAccepted);
+        acceptedSize += bufferAccepted;
+        if (ret != 0) {
+            LOG(ERROR) << "ProcessStreamDataBatch accepted " << acceptedSize << " bytes";
+            return ret;
+        }
+    }
+    return 0;
+}
+
+int32_t SysInstallerServer::ProcessStreamSharedDataBatch(uint32_t size, uint32_t &acceptedSize)
+{
+    DEFINE_EXIT_GUARD();
+    return StreamInstallerManager::GetInstance().ProcessSharedStreamDataBatch(size, acceptedSize);
+}
+
+int32_t SysInstallerServer::SetStreamSessionConfig(const StreamSessionConfig &config)
+{
+    LOG(INFO) << "SetStreamSessionConfig";
+    DEFINE_EXIT_GUARD();
+    return StreamInstallerManager::GetInstance().SetSessionConfig(config);
+}
+
+int32_t SysInstallerServer::GetStreamUpdateStats(StreamUpdateStats &stats)
+{
+    LOG(INFO) << "GetStreamUpdateStats";
+    DEFINE_EXIT_GUARD();
+    return StreamInstallerManager::GetInstance().GetStreamUpdateStats(stats);
+}
+
 int32_t SysInstallerServer::SetUpdateCallback(const std::string &taskId,
     const sptr<ISysInstallerCallback> &updateCallback)
 {
@@ -377,10 +449,23 @@ bool SysInstallerServer::IsPermissionGranted(void)
     return isPermissionGranted;
 }
 
-bool SysInstallerServer::CheckCallingPerm(void)
+static bool IsStreamDataCode(uint32_t code)
+{
+    // stream chunks arrive tens of thousands of times per update, keep them out of the log
+    return code == static_cast<uint32_t>(ISysInstallerIpcCode::COMMAND_PROCESS_STREAM_DATA) ||
+        code == static_cast<uint32_t>(ISysInstallerIpcCode::COMMAND_PROCESS_STREAM_SHARED_DATA) ||
+        code == static_cast<uint32_t>(ISysInstallerIpcCode::COMMAND_TRY_PROCESS_STREAM_DATA) ||
+        code == static_cast<uint32_t>(ISysInstallerIpcCode::COMMAND_TRY_PROCESS_STREAM_SHARED_DATA) ||
+        code == static_cast<uint32_t>(ISysInstallerIpcCode::COMMAND_PROCESS_STREAM_DATA_BATCH) ||
+        code == static_cast<uint32_t>(ISysInstallerIpcCode::COMMAND_PROCESS_STREAM_SHARED_DATA_BATCH);
+}
+
+bool SysInstallerServer::CheckCallingPerm(bool isQuiet)
 {
     int32_t callingUid = OHOS::IPCSkeleton::GetCallingUid();
-    LOG(INFO) << "CheckCallingPerm callingUid:" << callingUid;
+    if (!isQuiet) {
+        LOG(INFO) << "CheckCallingPerm callingUid:" << callingUid;
+    }
     if (callingUid == 0) {
         return true;
     }
@@ -389,8 +474,11 @@ bool SysInstallerServer::CheckCallingPerm(void)
 
 int32_t SysInstallerServer::CallbackEnter([[maybe_unused]] uint32_t code)
 {
-    LOG(INFO) << "Received stub message:" << code << ", callingUid:" << IPCSkeleton::GetCallingUid();
-    if (!CheckCallingPerm()) {
+    bool isStreamData = IsStreamDataCode(code);
+    if (!isStreamData) {
+        LOG(INFO) << "Received stub message:" << code << ", callingUid:" << IPCSkeleton::GetCallingUid();
+    }
+    if (!CheckCallingPerm(isStreamData)) {
         LOG(ERROR) << "SysInstallerServer CheckCallingPerm fail";
         return ERR_INVALID_VALUE;
     }
@@ -32,6 +32,7 @@ public:
     virtual int GetUpdateStatus();
     virtual int SetUpdateCallback(const sptr<ISysInstallerCallback> &updateCallback);
     virtual void UpdateCallback(UpdateStatus updateStatus, int dealLen, const std::string &resultMsg);
+    virtual void CreditsCallback(uint32_t credits);
 
 protected:
     UpdateStatus updateStatus_ = UpdateStatus::UPDATE_STATE_INIT;
@@ -59,9 +59,25 @@ void StreamStatusManager::UpdateCallback(UpdateStatus updateStatus, int dealLen,
     }
 
     updateStatus_ = updateStatus;
-    LOG(INFO) << "status:" << static_cast<int>(updateStatus_) << " dealLen:"  << dealLen << " msg:" << resultMsg;
+    // ongoing reports come once per chunk, the stream pipeline logs a periodic summary instead
+    if (updateStatus_ == UpdateStatus::UPDATE_STATE_ONGOING) {
+        LOG(DEBUG) << "status:" << static_cast<int>(updateStatus_) << " dealLen:"  << dealLen;
+    } else {
+        LOG(INFO) << "status:" << static_cast<int>(updateStatus_) << " dealLen:"  << dealLen << " msg:" << resultMsg;
+    }
     updateCallback_->OnUpgradeDealLen(updateStatus_, dealLen, resultMsg);
 }
 
+void StreamStatusManager::CreditsCallback(uint32_t credits)
+{
+    std::lock_guard<std::mutex> lock(updateCbMutex_);
+    if (updateCallback_ == nullptr) {
+        LOG(ERROR) << "updateCallback_ null";
+        return;
+    }
+    LOG(DEBUG) << "stream credits:" << credits;
+    updateCallback_->OnStreamCredits(credits);
+}
+
 } // namespace SysInstaller
 } // namespace OHOS
@@ -28,6 +28,8 @@ public:
     virtual void OnUpgradeDealLen(UpdateStatus updateStatus, int dealLen,
         const std::string &resultMsg) = 0;
     virtual void OnUpgradeFeatureStatus(const FeatureStatus &statusInfo) {};
+    // stream chunks can be pushed again after TryProcessStreamData returned STREAM_PUSH_WOULD_BLOCK
+    virtual void OnStreamCredits(uint32_t credits) {};
 };
 } // namespace SysInstaller
 } // namespace OHOS
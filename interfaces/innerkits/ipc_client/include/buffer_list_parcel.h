@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef BUFFER_LIST_PARCEL_H
+#define BUFFER_LIST_PARCEL_H
+#include <vector>
+#include "buffer_info_parcel.h"
+#include "parcel.h"
+
+namespace OHOS {
+namespace SysInstaller {
+constexpr uint32_t STREAM_BATCH_MAX_BUFFERS = 64;
+// stay well below the binder transaction buffer, bigger batches are sent in several transactions
+constexpr uint32_t STREAM_BATCH_MAX_SIZE = 512 * 1024;
+
+// several stream chunks in one transaction, they are fed to the stream in list order
+struct BufferListParcel final : public Parcelable {
+    BufferListParcel() = default;
+    ~BufferListParcel() override = default;
+    bool Marshalling(Parcel &out) const override;
+    static BufferListParcel* Unmarshalling(Parcel &in);
+    std::vector<BufferInfo> bufferInfos;
+};
+} // namespace SysInstaller
+} // namespace OHOS
+#endif // BUFFER_LIST_PARCEL_H
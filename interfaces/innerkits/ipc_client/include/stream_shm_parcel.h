@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STREAM_SHM_PARCEL_H
+#define STREAM_SHM_PARCEL_H
+#include "ashmem.h"
+#include "parcel.h"
+
+namespace OHOS {
+namespace SysInstaller {
+// ring of slots shared between the stream client and sys_installer, slot i starts at i * slotSize
+struct StreamShmInfo final {
+public:
+    sptr<Ashmem> ashmem;
+    uint32_t slotSize;
+    uint32_t slotNum;
+};
+struct StreamShmParcel final : public Parcelable {
+    StreamShmParcel() = default;
+    ~StreamShmParcel() override = default;
+    bool Marshalling(Parcel &out) const override;
+    static StreamShmParcel* Unmarshalling(Parcel &in);
+    StreamShmInfo shmInfo;
+};
+} // namespace SysInstaller
+} // namespace OHOS
+#endif // STREAM_SHM_PARCEL_H
@@ -32,6 +32,7 @@ public:
     ErrCode OnUpgradeProgress(UpdateStatus updateStatus, int percent, const std::string &resultMsg) override;
     ErrCode OnUpgradeDealLen(UpdateStatus updateStatus, int dealLen, const std::string &resultMsg) override;
     ErrCode OnUpgradeFeatureStatus(const FeatureStatus &statusInfo) override;
+    ErrCode OnStreamCredits(uint32_t credits) override;
     void RegisterCallback(sptr<ISysInstallerCallbackFunc> callback);
 
 private:
@@ -16,6 +16,8 @@
 #ifndef SYS_INSTALLER_KITS_IMPL_H
 #define SYS_INSTALLER_KITS_IMPL_H
 
+#include "ashmem.h"
+#include "buffer_info_parcel.h"
 #include "singleton.h"
 #include "isys_installer.h"
 #include "isys_installer_callback.h"
@@ -31,7 +33,17 @@ public:
     virtual int32_t StartUpdatePackageZip(const std::string &taskId, const std::string &pkgPath);
     virtual int32_t StartStreamUpdate();
     virtual int32_t StopStreamUpdate();
+    virtual int32_t ResumeStreamUpdate(uint64_t &offset);
     virtual int32_t ProcessStreamData(const uint8_t *buffer, uint32_t size);
+    // returns at once, STREAM_PUSH_WOULD_BLOCK means retry after ISysInstallerCallbackFunc::OnStreamCredits
+    virtual int32_t TryProcessStreamData(const uint8_t *buffer, uint32_t size, StreamPushResult &pushResult,
+        uint32_t &credits);
+    // one transaction per STREAM_BATCH_MAX_SIZE bytes (or per shared memory ring), acceptedSize is the
+    // prefix of the concatenated buffers that reached the stream
+    virtual int32_t ProcessStreamDataBatch(const std::vector<BufferInfo> &buffers, uint64_t &acceptedSize);
+    virtual bool IsStreamSharedMemoryEnabled();
+    virtual int32_t SetStreamSessionConfig(const StreamSessionConfig &config);
+    virtual int32_t GetStreamUpdateStats(StreamUpdateStats &stats);
     virtual int32_t SetUpdateCallback(const std::string &taskId, sptr<ISysInstallerCallbackFunc> callback);
     virtual int32_t GetUpdateStatus(const std::string &taskId);
     virtual int32_t StartUpdateParaZip(const std::string &taskId, const std::string &pkgPath,
@@ -79,6 +91,16 @@ public:
 
 private:
     int32_t Init();
+    static sptr<Ashmem> CreateStreamSharedMemory(uint32_t slotSize, uint32_t slotNum);
+    int32_t InitStreamSharedMemory(const sptr<ISysInstaller> &updateService, uint32_t slotSize, uint32_t slotNum);
+    // on failure the previously registered mapping stays in use
+    int32_t RegisterStreamSharedMemory(const sptr<ISysInstaller> &updateService, const sptr<Ashmem> &ashmem,
+        uint32_t slotSize, uint32_t slotNum);
+    void ReleaseStreamSharedMemory();
+    int32_t ProcessStreamSharedData(const sptr<ISysInstaller> &updateService, const uint8_t *buffer, uint32_t size);
+    int32_t ProcessStreamSharedDataBatch(const sptr<ISysInstaller> &updateService,
+        const std::vector<BufferInfo> &buffers, uint64_t &acceptedSize);
+    int32_t FlushStreamShmBatch(const sptr<ISysInstaller> &updateService, uint32_t &fillSize, uint64_t &acceptedSize);
     SysInstallerKitsImpl() = default;
     virtual ~SysInstallerKitsImpl() = default;
 
@@ -101,6 +123,12 @@ public:
 
     std::mutex serviceMutex_;
     std::condition_variable serviceCv_;
+
+    std::mutex streamShmLock_;
+    sptr<Ashmem> streamShm_ {};
+    uint32_t streamShmNextSlot_ {0};
+    uint32_t streamShmSlotSize_ {0};
+    uint32_t streamShmSlotNum_ {0};
 };
 } // namespace SysInstaller
 } // namespace OHOS
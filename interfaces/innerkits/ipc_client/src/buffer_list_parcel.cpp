@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "buffer_list_parcel.h"
+
+namespace OHOS {
+namespace SysInstaller {
+bool BufferListParcel::Marshalling(Parcel &out) const
+{
+    if (bufferInfos.size() > STREAM_BATCH_MAX_BUFFERS) {
+        return false;
+    }
+    if (!(out.WriteUint32(static_cast<uint32_t>(bufferInfos.size())))) {
+        return false;
+    }
+    for (const auto &bufferInfo : bufferInfos) {
+        if (!(out.WriteUint32(bufferInfo.size)) || !(out.WriteBuffer(bufferInfo.buffer, bufferInfo.size))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+BufferListParcel* BufferListParcel::Unmarshalling(Parcel &in)
+{
+    uint32_t count = in.ReadUint32();
+    if (count > STREAM_BATCH_MAX_BUFFERS) {
+        return nullptr;
+    }
+    BufferListParcel* bufferListParcel = new (std::nothrow) BufferListParcel();
+    if (bufferListParcel == nullptr) {
+        return nullptr;
+    }
+
+    bufferListParcel->bufferInfos.reserve(count);
+    for (uint32_t i = 0; i < count; i++) {
+        BufferInfo bufferInfo;
+        bufferInfo.size = in.ReadUint32();
+        // the buffers point into the parcel, they stay valid until the stub returns
+        bufferInfo.buffer = in.ReadBuffer(bufferInfo.size);
+        if (bufferInfo.buffer == nullptr) {
+            delete bufferListParcel;
+            return nullptr;
+        }
+        bufferListParcel->bufferInfos.push_back(bufferInfo);
+    }
+    return bufferListParcel;
+}
+} // namespace SysInstaller
+} // namespace OHOS
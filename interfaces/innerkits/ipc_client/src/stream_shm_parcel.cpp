@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "stream_shm_parcel.h"
+
+#include "message_parcel.h"
+
+namespace OHOS {
+namespace SysInstaller {
+bool StreamShmParcel::Marshalling(Parcel &out) const
+{
+    if (shmInfo.ashmem == nullptr) {
+        return false;
+    }
+    if (!(out.WriteUint32(shmInfo.slotSize)) || !(out.WriteUint32(shmInfo.slotNum))) {
+        return false;
+    }
+    // sequenceables are always carried by a MessageParcel, which is able to transfer the ashmem fd
+    return static_cast<MessageParcel &>(out).WriteAshmem(shmInfo.ashmem);
+}
+
+StreamShmParcel* StreamShmParcel::Unmarshalling(Parcel &in)
+{
+    StreamShmParcel* streamShmParcel = new (std::nothrow) StreamShmParcel();
+    if (streamShmParcel == nullptr) {
+        return nullptr;
+    }
+
+    streamShmParcel->shmInfo.slotSize = in.ReadUint32();
+    streamShmParcel->shmInfo.slotNum = in.ReadUint32();
+    streamShmParcel->shmInfo.ashmem = static_cast<MessageParcel &>(in).ReadAshmem();
+    if (streamShmParcel->shmInfo.ashmem == nullptr) {
+        delete streamShmParcel;
+        return nullptr;
+    }
+    return streamShmParcel;
+}
+} // namespace SysInstaller
+} // namespace OHOS
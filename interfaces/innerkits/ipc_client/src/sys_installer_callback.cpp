@@ -46,7 +46,12 @@ ErrCode SysInstallerCallback::OnUpgradeProgress(UpdateStatus updateStatus, int p
 ErrCode SysInstallerCallback::OnUpgradeDealLen(UpdateStatus updateStatus, int dealLen,
     const std::string &resultMsg)
 {
-    LOG(INFO) << "updateStatus: " << static_cast<int>(updateStatus) << " dealLen:" << dealLen << " msg:" << resultMsg;
+    if (updateStatus == UpdateStatus::UPDATE_STATE_ONGOING) {
+        LOG(DEBUG) << "updateStatus: " << static_cast<int>(updateStatus) << " dealLen:" << dealLen;
+    } else {
+        LOG(INFO) << "updateStatus: " << static_cast<int>(updateStatus) << " dealLen:" << dealLen << " msg:" <<
+            resultMsg;
+    }
     if (callback_ != nullptr) {
         callback_->OnUpgradeDealLen(updateStatus, dealLen, resultMsg);
     }
@@ -63,6 +68,15 @@ ErrCode SysInstallerCallback::OnUpgradeFeatureStatus(const FeatureStatus &status
     return 0;
 }
 
+ErrCode SysInstallerCallback::OnStreamCredits(uint32_t credits)
+{
+    LOG(DEBUG) << "stream credits:" << credits;
+    if (callback_ != nullptr) {
+        callback_->OnStreamCredits(credits);
+    }
+    return 0;
+}
+
 void SysInstallerCallback::RegisterCallback(sptr<ISysInstallerCallbackFunc> callback)
 {
     callback_ = callback;
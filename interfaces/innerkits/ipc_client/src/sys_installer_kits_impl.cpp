@@ -15,6 +15,7 @@
 
 #include "sys_installer_kits_impl.h"
 
+#include <algorithm>
 #include <unistd.h>
 #include <sys/stat.h>
 
@@ -32,6 +33,8 @@
 #include "sys_installer_load_callback.h"
 #include "sys_installer_proxy.h"
 #include "buffer_info_parcel.h"
+#include "buffer_list_parcel.h"
+#include "stream_shm_parcel.h"
 
 namespace OHOS {
 namespace SysInstaller {
@@ -39,6 +42,7 @@ using namespace Updater;
 using namespace Updater::Utils;
 using namespace Utils;
 constexpr int LOAD_SA_TIMEOUT_MS = 3;
+constexpr const char *STREAM_SHM_NAME = "sys_installer_stream";
 
 SysInstallerKitsImpl &SysInstallerKitsImpl::GetInstance()
 {
@@ -56,6 +60,9 @@ void SysInstallerKitsImpl::ResetService(const wptr<IRemoteObject>& remote)
         if ((object != nullptr) && (remote == object)) {
             object->RemoveDeathRecipient(deathRecipient_);
             sysInstaller_ = nullptr;
+            // the mapping registered with the dead instance is useless for the next one
+            std::lock_guard<std::mutex> shmLock(streamShmLock_);
+            ReleaseStreamSharedMemory();
         }
     }
 }
@@ -151,6 +158,117 @@ int32_t SysInstallerKitsImpl::SysInstallerInit(const std::string &taskId, bool b
         return -1;
     }
     updateService->SysInstallerInit(taskId, bStreamUpgrade);
+    if (bStreamUpgrade &&
+        InitStreamSharedMemory(updateService, STREAM_DEFAULT_SLOT_SIZE, STREAM_DEFAULT_SLOT_NUM) != 0) {
+        LOG(WARNING) << "stream shared memory unavailable, fall back to parcel transport";
+    }
+    return 0;
+}
+
+sptr<Ashmem> SysInstallerKitsImpl::CreateStreamSharedMemory(uint32_t slotSize, uint32_t slotNum)
+{
+    uint64_t shmSize = static_cast<uint64_t>(slotSize) * slotNum;
+    if (shmSize == 0 || shmSize > INT32_MAX) {
+        LOG(ERROR) << "invalid stream shared memory size:" << shmSize;
+        return nullptr;
+    }
+    sptr<Ashmem> ashmem = Ashmem::CreateAshmem(STREAM_SHM_NAME, static_cast<int32_t>(shmSize));
+    if (ashmem == nullptr) {
+        LOG(ERROR) << "CreateAshmem failed";
+        return nullptr;
+    }
+    if (!ashmem->MapReadAndWriteAshmem()) {
+        LOG(ERROR) << "MapReadAndWriteAshmem failed";
+        ashmem->CloseAshmem();
+        return nullptr;
+    }
+    return ashmem;
+}
+
+int32_t SysInstallerKitsImpl::InitStreamSharedMemory(const sptr<ISysInstaller> &updateService,
+    uint32_t slotSize, uint32_t slotNum)
+{
+    sptr<Ashmem> ashmem = CreateStreamSharedMemory(slotSize, slotNum);
+    if (ashmem == nullptr) {
+        return -1;
+    }
+    return RegisterStreamSharedMemory(updateService, ashmem, slotSize, slotNum);
+}
+
+int32_t SysInstallerKitsImpl::RegisterStreamSharedMemory(const sptr<ISysInstaller> &updateService,
+    const sptr<Ashmem> &ashmem, uint32_t slotSize, uint32_t slotNum)
+{
+    std::lock_guard<std::mutex> lock(streamShmLock_);
+    StreamShmParcel shmParcel;
+    shmParcel.shmInfo.ashmem = ashmem;
+    shmParcel.shmInfo.slotSize = slotSize;
+    shmParcel.shmInfo.slotNum = slotNum;
+    int32_t ret = updateService->RegisterStreamSharedMemory(shmParcel);
+    if (ret != 0) {
+        LOG(ERROR) << "RegisterStreamSharedMemory ret:" << ret;
+        ashmem->UnmapAshmem();
+        ashmem->CloseAshmem();
+        return -1;
+    }
+    // the service switched to the new mapping, the old one is not read any more
+    ReleaseStreamSharedMemory();
+    streamShm_ = ashmem;
+    streamShmNextSlot_ = 0;
+    streamShmSlotSize_ = slotSize;
+    streamShmSlotNum_ = slotNum;
+    LOG(INFO) << "stream shared memory ready, slot size:" << slotSize << " slot num:" << slotNum;
+    return 0;
+}
+
+void SysInstallerKitsImpl::ReleaseStreamSharedMemory()
+{
+    if (streamShm_ == nullptr) {
+        return;
+    }
+    streamShm_->UnmapAshmem();
+    streamShm_->CloseAshmem();
+    streamShm_ = nullptr;
+    streamShmSlotSize_ = 0;
+    streamShmSlotNum_ = 0;
+}
+
+bool SysInstallerKitsImpl::IsStreamSharedMemoryEnabled()
+{
+    std::lock_guard<std::mutex> lock(streamShmLock_);
+    return streamShm_ != nullptr;
+}
+
+int32_t SysInstallerKitsImpl::SetStreamSessionConfig(const StreamSessionConfig &config)
+{
+    LOG(INFO) << "SetStreamSessionConfig slotSize:" << config.slotSize << " slotNum:" << config.slotNum;
+    auto updateService = GetService();
+    if (updateService == nullptr) {
+        LOG(ERROR) << "Get updateService failed";
+        return -1;
+    }
+    if (!IsStreamSharedMemoryEnabled()) {
+        int32_t ret = updateService->SetStreamSessionConfig(config);
+        LOG(INFO) << "SetStreamSessionConfig ret:" << ret;
+        return ret;
+    }
+    // the slot ring is remapped so a slot carries a whole chunk of the new size. map it before touching the
+    // session, a chunk of the new size would not fit a parcel if the shared memory were lost on the way
+    sptr<Ashmem> ashmem = CreateStreamSharedMemory(config.slotSize, config.slotNum);
+    if (ashmem == nullptr) {
+        LOG(ERROR) << "SetStreamSessionConfig map shared memory failed";
+        return -1;
+    }
+    int32_t ret = updateService->SetStreamSessionConfig(config);
+    LOG(INFO) << "SetStreamSessionConfig ret:" << ret;
+    if (ret != 0) {
+        ashmem->UnmapAshmem();
+        ashmem->CloseAshmem();
+        return ret;
+    }
+    if (RegisterStreamSharedMemory(updateService, ashmem, config.slotSize, config.slotNum) != 0) {
+        LOG(ERROR) << "SetStreamSessionConfig register shared memory failed";
+        return -1;
+    }
     return 0;
 }
 
@@ -193,22 +311,205 @@ int32_t SysInstallerKitsImpl::StopStreamUpdate()
     return ret;
 }
 
+int32_t SysInstallerKitsImpl::ResumeStreamUpdate(uint64_t &offset)
+{
+    LOG(INFO) << "ResumeStreamUpdate";
+    auto updateService = GetService();
+    if (updateService == nullptr) {
+        LOG(ERROR) << "Get updateService failed";
+        return -1;
+    }
+    int32_t ret = updateService->ResumeStreamUpdate(offset);
+    LOG(INFO) << "ResumeStreamUpdate ret:" << ret << " offset:" << offset;
+    return ret;
+}
+
 int32_t SysInstallerKitsImpl::ProcessStreamData(const uint8_t *buffer, uint32_t size)
 {
-    LOG(INFO) << "ProcessStreamData";
     auto updateService = GetService();
     BufferInfoParcel bufferParcel;
     if (updateService == nullptr) {
         LOG(ERROR) << "Get updateService failed";
         return -1;
     }
+    if (IsStreamSharedMemoryEnabled()) {
+        return ProcessStreamSharedData(updateService, buffer, size);
+    }
+    if (size > STREAM_BATCH_MAX_SIZE) {
+        LOG(ERROR) << "ProcessStreamData chunk too large for a parcel:" << size;
+        return -1;
+    }
     bufferParcel.bufferInfo.buffer = buffer;
     bufferParcel.bufferInfo.size = size;
     int32_t ret = updateService->ProcessStreamData(bufferParcel);
-    LOG(INFO) << "ProcessStreamData ret:" << ret;
+    if (ret != 0) {
+        LOG(ERROR) << "ProcessStreamData ret:" << ret;
+    }
+    return ret;
+}
+
+int32_t SysInstallerKitsImpl::ProcessStreamSharedData(const sptr<ISysInstaller> &updateService,
+    const uint8_t *buffer, uint32_t size)
+{
+    std::lock_guard<std::mutex> lock(streamShmLock_);
+    if (streamShm_ == nullptr || buffer == nullptr || size > streamShmSlotSize_) {
+        LOG(ERROR) << "stream shared memory not ready or chunk too large:" << size;
+        return -1;
+    }
+    // the server copies the slot out before replying, so the slot is free again once the call returns
+    uint32_t slotIndex = streamShmNextSlot_;
+    if (!streamShm_->WriteToAshmem(buffer, static_cast<int32_t>(size),
+        static_cast<int32_t>(slotIndex * streamShmSlotSize_))) {
+        LOG(ERROR) << "WriteToAshmem failed, slot:" << slotIndex;
+        return -1;
+    }
+    streamShmNextSlot_ = (slotIndex + 1) % streamShmSlotNum_;
+    int32_t ret = updateService->ProcessStreamSharedData(slotIndex, size);
+    if (ret != 0) {
+        LOG(ERROR) << "ProcessStreamSharedData ret:" << ret;
+    }
+    return ret;
+}
+
+int32_t SysInstallerKitsImpl::TryProcessStreamData(const uint8_t *buffer, uint32_t size,
+    StreamPushResult &pushResult, uint32_t &credits)
+{
+    auto updateService = GetService();
+    if (updateService == nullptr) {
+        LOG(ERROR) << "Get updateService failed";
+        return -1;
+    }
+    int32_t ret = 0;
+    if (IsStreamSharedMemoryEnabled()) {
+        std::lock_guard<std::mutex> lock(streamShmLock_);
+        if (streamShm_ == nullptr || buffer == nullptr || size > streamShmSlotSize_) {
+            LOG(ERROR) << "stream shared memory not ready or chunk too large:" << size;
+            return -1;
+        }
+        uint32_t slotIndex = streamShmNextSlot_;
+        if (!streamShm_->WriteToAshmem(buffer, static_cast<int32_t>(size),
+            static_cast<int32_t>(slotIndex * streamShmSlotSize_))) {
+            LOG(ERROR) << "WriteToAshmem failed, slot:" << slotIndex;
+            return -1;
+        }
+        ret = updateService->TryProcessStreamSharedData(slotIndex, size, pushResult, credits);
+        // a rejected slot was not copied, the next attempt may simply overwrite it
+        if (ret == 0 && pushResult == StreamPushResult::STREAM_PUSH_ACCEPTED) {
+            streamShmNextSlot_ = (slotIndex + 1) % streamShmSlotNum_;
+        }
+    } else {
+        if (size > STREAM_BATCH_MAX_SIZE) {
+            LOG(ERROR) << "TryProcessStreamData chunk too large for a parcel:" << size;
+            return -1;
+        }
+        BufferInfoParcel bufferParcel;
+        bufferParcel.bufferInfo.buffer = buffer;
+        bufferParcel.bufferInfo.size = size;
+        ret = updateService->TryProcessStreamData(bufferParcel, pushResult, credits);
+    }
+    if (ret != 0) {
+        LOG(ERROR) << "TryProcessStreamData ret:" << ret;
+    }
     return ret;
 }
 
+int32_t SysInstallerKitsImpl::ProcessStreamDataBatch(const std::vector<BufferInfo> &buffers, uint64_t &acceptedSize)
+{
+    acceptedSize = 0;
+    auto updateService = GetService();
+    if (updateService == nullptr) {
+        LOG(ERROR) << "Get updateService failed";
+        return -1;
+    }
+    if (IsStreamSharedMemoryEnabled()) {
+        return ProcessStreamSharedDataBatch(updateService, buffers, acceptedSize);
+    }
+    BufferListParcel bufferListParcel;
+    uint32_t parcelSize = 0;
+    auto flush = [&updateService, &bufferListParcel, &parcelSize, &acceptedSize] () {
+        if (bufferListParcel.bufferInfos.empty()) {
+            return 0;
+        }
+        uint32_t accepted = 0;
+        int32_t ret = updateService->ProcessStreamDataBatch(bufferListParcel, accepted);
+        acceptedSize += accepted;
+        bufferListParcel.bufferInfos.clear();
+        parcelSize = 0;
+        if (ret != 0) {
+            LOG(ERROR) << "ProcessStreamDataBatch ret:" << ret << " accepted:" << acceptedSize;
+        }
+        return ret;
+    };
+    for (const auto &bufferInfo : buffers) {
+        if (bufferInfo.buffer == nullptr) {
+            LOG(ERROR) << "ProcessStreamDataBatch null buffer";
+            return -1;
+        }
+        // buffers larger than a transaction are split, the parcel copies the bytes so no client side copy
+        for (uint32_t offset = 0; offset < bufferInfo.size;) {
+            uint32_t len = std::min(bufferInfo.size - offset, STREAM_BATCH_MAX_SIZE - parcelSize);
+            bufferListParcel.bufferInfos.push_back(BufferInfo { bufferInfo.buffer + offset, len });
+            parcelSize += len;
+            offset += len;
+            if ((parcelSize == STREAM_BATCH_MAX_SIZE ||
+                bufferListParcel.bufferInfos.size() == STREAM_BATCH_MAX_BUFFERS) && flush() != 0) {
+                return -1;
+            }
+        }
+    }
+    return flush() == 0 ? 0 : -1;
+}
+
+int32_t SysInstallerKitsImpl::ProcessStreamSharedDataBatch(const sptr<ISysInstaller> &updateService,
+    const std::vector<BufferInfo> &buffers, uint64_t &acceptedSize)
+{
+    std::lock_guard<std::mutex> lock(streamShmLock_);
+    if (streamShm_ == nullptr) {
+        LOG(ERROR) << "stream shared memory not ready";
+        return -1;
+    }
+    // the whole ring is one batch, the server copies it out before replying
+    uint32_t ringSize = streamShmSlotSize_ * streamShmSlotNum_;
+    uint32_t fillSize = 0;
+    for (const auto &bufferInfo : buffers) {
+        if (bufferInfo.buffer == nullptr) {
+            LOG(ERROR) << "ProcessStreamDataBatch null buffer";
+            return -1;
+        }
+        for (uint32_t offset = 0; offset < bufferInfo.size;) {
+            uint32_t len = std::min(bufferInfo.size - offset, ringSize - fillSize);
+            if (!streamShm_->WriteToAshmem(bufferInfo.buffer + offset, static_cast<int32_t>(len),
+                static_cast<int32_t>(fillSize))) {
+                LOG(ERROR) << "WriteToAshmem failed, offset:" << fillSize;
+                return -1;
+            }
+            fillSize += len;
+            offset += len;
+            if (fillSize == ringSize && FlushStreamShmBatch(updateService, fillSize, acceptedSize) != 0) {
+                return -1;
+            }
+        }
+    }
+    return FlushStreamShmBatch(updateService, fillSize, acceptedSize);
+}
+
+int32_t SysInstallerKitsImpl::FlushStreamShmBatch(const sptr<ISysInstaller> &updateService, uint32_t &fillSize,
+    uint64_t &acceptedSize)
+{
+    if (fillSize == 0) {
+        return 0;
+    }
+    uint32_t accepted = 0;
+    int32_t ret = updateService->ProcessStreamSharedDataBatch(fillSize, accepted);
+    acceptedSize += accepted;
+    fillSize = 0;
+    if (ret != 0) {
+        LOG(ERROR) << "ProcessStreamSharedDataBatch ret:" << ret << " accepted:" << acceptedSize;
+        return -1;
+    }
+    return 0;
+}
+
 int32_t SysInstallerKitsImpl::SetUpdateCallback(const std::string &taskId, sptr<ISysInstallerCallbackFunc> callback)
 {
     LOG(INFO) << "SetUpdateCallback";
@@ -243,6 +544,19 @@ int32_t SysInstallerKitsImpl::GetUpdateStatus(const std::string &taskId)
     return updateService->GetUpdateStatus(taskId);
 }
 
+int32_t SysInstallerKitsImpl::GetStreamUpdateStats(StreamUpdateStats &stats)
+{
+    LOG(INFO) << "GetStreamUpdateStats";
+    auto updateService = GetService();
+    if (updateService == nullptr) {
+        LOG(ERROR) << "Get updateService failed";
+        return -1;
+    }
+    int32_t ret = updateService->GetStreamUpdateStats(stats);
+    LOG(INFO) << "GetStreamUpdateStats ret:" << ret;
+    return ret;
+}
+
 int32_t SysInstallerKitsImpl::StartUpdateParaZip(const std::string &taskId, const std::string &pkgPath,
     const std::string &location, const std::string &cfgDir)
 {
@@ -33,11 +33,13 @@ public:
     ~ModuleFileRepository();
     void InitRepository(const std::string &hmpName, const Timer &timer);
     std::unique_ptr<ModuleFile> GetModuleFile(const std::string &pathPrefix, const std::string &hmpName) const;
+    // borrowed view into the repository, valid until Clear
+    const ModuleFile *FindModuleFile(const std::string &pathPrefix, const std::string &hmpName) const;
     bool IsPreInstalledModule(const ModuleFile &moduleFile) const;
     void Clear();
     void SaveInstallerResult(const std::string &fpInfo, const std::string &hmpName,
         int result, const std::string &resultInfo, const Timer &timer) const;
-    const std::unordered_map<std::string, std::unordered_map<std::string, ModuleFile>> &GetModuleMap(void);
+    const std::unordered_map<std::string, std::unordered_map<std::string, ModuleFile>> &GetModuleMap(void) const;
 private:
     void ProcessFile(const std::string &hmpName, const std::string &path, const std::string &file,
         std::unordered_map<std::string, ModuleFile> &fileMap, const Timer &timer) const;
@@ -28,6 +28,12 @@ namespace OHOS {
 namespace SysInstaller {
 using ImageVerifyFunc = std::function<bool(ModuleFile &, std::string &)>;
 
+// state of one hmp activation, activations of different hmps run concurrently
+struct ModuleActivateContext {
+    ModuleFileRepository repository;
+    std::list<ModuleFile> moduleFileList;
+};
+
 class ModuleUpdate {
 public:
     static ModuleUpdate &GetInstance();
@@ -38,21 +44,22 @@ public:
     void HandleExtraArgs(int argc, char **argv) const;
 
 private:
-    void PrepareModuleFileList(const ModuleUpdateStatus &status);
-    bool ActivateModules(ModuleUpdateStatus &status, const Timer &timer);
+    void PrepareModuleFileList(ModuleActivateContext &context, const ModuleUpdateStatus &status);
+    bool ActivateModules(ModuleActivateContext &context, ModuleUpdateStatus &status, const Timer &timer);
     bool MountModulePackage(ModuleFile &moduleFile, const bool mountOnVerity);
     void ReportModuleUpdateStatus(const ModuleUpdateStatus &status) const;
     void WaitDevice(const std::string &blockDevice) const;
     bool CheckMountComplete(const std::string &hmpName) const;
-    void ProcessHmpFile(const std::string &hmpFile, const ModuleUpdateStatus &status, const Timer &timer);
-    std::unique_ptr<ModuleFile> GetLatestUpdateModulePackage(const std::string &hmpName);
-    bool CheckRevert(const std::string &hmpName);
+    void ProcessHmpFile(ModuleActivateContext &context, const std::string &hmpFile, const ModuleUpdateStatus &status,
+        const Timer &timer);
+    // modulePath is where the returned file is mounted from, an update package is staged to the active dir
+    const ModuleFile *GetLatestUpdateModulePackage(const ModuleFileRepository &repository,
+        const std::string &hmpName, std::string &modulePath);
+    bool CheckRevert(const ModuleFileRepository &repository, const std::string &hmpName);
     std::string CreateMountPoint(const ModuleFile &moduleFile) const;
     bool VerifyImageAndCreateDm(ModuleFile &moduleFile, bool mountOnVerity, std::string &blockDevice);
     void SetParameterFromFile(void) const;
 
-    std::list<ModuleFile> moduleFileList_;
-    ModuleFileRepository repository_;
     ImageVerifyFunc ImageVerifyFunc_ = nullptr;
     int32_t registeredLevel_ = 0;
 };
@@ -17,6 +17,10 @@
 #ifndef MODULE_UPDATE_TASK_H
 #define MODULE_UPDATE_TASK_H
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
 #include "module_ipc_helper.h"
 #include "singleton.h"
 #include "thread_pool.h"
@@ -40,17 +44,23 @@ public:
     bool GetTaskResult();
     bool AddTask(const std::string &hmpName);
     void ClearTask();
-    void Start();
+    void Start(size_t threadNum = 1);
     void Stop();
     size_t GetCurTaskNum();
+    // blocks until every added task has finished, tasks count down as they complete
+    void WaitAllTasks();
+    void FinishTask();
 
 private:
     static constexpr size_t MAX_TASK_NUM = 100; // 100 is max task number
     ModuleUpdateTaskManager() {}
     ModuleUpdateTaskManager(const ModuleUpdateTaskManager&) = delete;
     OHOS::ThreadPool pool_;
-    bool taskResult_ = true;
-    size_t taskNum_;
+    std::atomic<bool> taskResult_ {true};
+    std::atomic<size_t> taskNum_ {0};
+    std::mutex pendingMutex_;
+    std::condition_variable pendingCond_;
+    size_t pendingTaskNum_ {0};
 };
 } // SysInstaller
 } // namespace OHOS
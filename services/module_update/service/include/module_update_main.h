@@ -37,7 +37,7 @@ public:
     int32_t ReportModuleUpdateStatus(const ModuleUpdateStatus &status);
     std::vector<HmpVersionInfo> GetHmpVersionInfo();
     void ExitModuleUpdate();
-    int32_t InstallModuleFile(const std::string &hmpName, const std::string &file);
+    int32_t InstallModuleFile(const std::string &hmpName, const std::string &file, bool isSignVerified = false);
     void CollectModulePackageInfo(const std::string &hmpName, std::list<ModulePackageInfo> &modulePackageInfos) const;
     bool BackupActiveModules(const std::string &hmpName) const;
     bool GetHmpVersion(const std::string &hmpPath, HmpVersionInfo &versionInfo);
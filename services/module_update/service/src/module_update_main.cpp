@@ -15,6 +15,7 @@
 
 #include "module_update_main.h"
 
+#include <atomic>
 #include <fcntl.h>
 #include <sys/types.h>
 #include <sys/stat.h>
@@ -24,7 +25,6 @@
 #include "directory_ex.h"
 #include "module_utils.h"
 #include "hisysevent_manager.h"
-#include "json_node.h"
 #include "log/log.h"
 #include "module_update_service.h"
 #include "parameter.h"
@@ -34,6 +34,7 @@
 #include "module_update_producer.h"
 #include "module_error_code.h"
 #include "module_file.h"
+#include "module_pack_info_cache.h"
 #include "module_update_verify.h"
 #include "package/package.h"
 #include "scope_guard.h"
@@ -178,15 +179,42 @@ int32_t ModuleUpdateMain::ReallyInstallModulePackage(const std::string &pkgPath,
         RemoveSpecifiedDir(hmpDir, false);
     };
     std::string outPath = hmpDir + "/";
-    if (!PrepareFileToDestDir(pkgPath, outPath)) {
+    // verify each module package as soon as it lands, while the rest of the hmp is still extracting
+    std::mutex signLock;
+    std::unordered_set<std::string> signedFiles;
+    std::atomic<bool> signFailed {false};
+    auto verifySign = [&signLock, &signedFiles, &signFailed](const std::string &file) {
+        if (!CheckFileSuffix(file, MODULE_PACKAGE_SUFFIX)) {
+            return true;
+        }
+        int32_t verifyRet = 0;
+        {
+            // extraction workers run this concurrently, the verify implementation is not known to be reentrant
+            static std::mutex verifyLock;
+            std::lock_guard<std::mutex> lock(verifyLock);
+            verifyRet = VerifyModulePackageSign(file);
+        }
+        if (verifyRet != 0) {
+            LOG(ERROR) << "Verify sign failed " << file;
+            signFailed = true;
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(signLock);
+        signedFiles.emplace(file);
+        return true;
+    };
+    // a vendor PrepareFileToDestDir is honored, module packages are then verified one by one while installing
+    bool prepared = IsDefaultPrepareFileToDestDir() ? ExtractPackageToDir(pkgPath, outPath, verifySign) :
+        PrepareFileToDestDir(pkgPath, outPath);
+    if (!prepared) {
         LOG(ERROR) << "Failed to prepare file, " << pkgPath;
-        return ModuleErrorCode::ERR_INSTALL_FAIL;
+        return signFailed ? ModuleErrorCode::ERR_VERIFY_FAIL : ModuleErrorCode::ERR_INSTALL_FAIL;
     }
     std::vector<std::string> files;
     GetDirFiles(hmpDir, files);
     int index = 1;
     for (auto &file : files) {
-        ret = InstallModuleFile(hmpName, file);
+        ret = InstallModuleFile(hmpName, file, signedFiles.find(file) != signedFiles.end());
         if (ret != ModuleErrorCode::MODULE_UPDATE_SUCCESS) {
             return ret;
         }
@@ -252,7 +280,7 @@ std::string ModuleUpdateMain::GetWorkHmpImagePath(const std::string &hmpName)
     return result;
 }
 
-int32_t ModuleUpdateMain::InstallModuleFile(const std::string &hmpName, const std::string &file)
+int32_t ModuleUpdateMain::InstallModuleFile(const std::string &hmpName, const std::string &file, bool isSignVerified)
 {
     if (!CheckFileSuffix(file, MODULE_PACKAGE_SUFFIX)) {
         return ModuleErrorCode::MODULE_UPDATE_SUCCESS;
@@ -262,7 +290,7 @@ int32_t ModuleUpdateMain::InstallModuleFile(const std::string &hmpName, const st
         return ModuleErrorCode::MODULE_UPDATE_SUCCESS;
     }
     // verify first, then open module file.
-    if (VerifyModulePackageSign(file) != 0) {
+    if (!isSignVerified && VerifyModulePackageSign(file) != 0) {
         LOG(ERROR) << "Verify sign failed " << file;
         return ModuleErrorCode::ERR_VERIFY_FAIL;
     }
@@ -381,29 +409,30 @@ bool ModuleUpdateMain::GetHmpVersion(const std::string &hmpPath, HmpVersionInfo
         LOG(ERROR) << "Verify sign failed " << packInfoPath;
         return false;
     }
-    std::string packInfo = GetContentFromZip(packInfoPath, PACK_INFO_NAME);
-    JsonNode root(packInfo);
-    const JsonNode &package = root["package"];
-    std::optional<std::string> name = package["name"].As<std::string>();
+    std::shared_ptr<const ModulePackInfoMeta> meta = ModulePackInfoCache::GetInstance().Get(packInfoPath);
+    if (meta == nullptr) {
+        LOG(ERROR) << "Failed to load pack info of " << packInfoPath;
+        return false;
+    }
+    const std::optional<std::string> &name = meta->name;
     if (!name.has_value()) {
         LOG(ERROR) << "count get name val";
         return false;
     }
 
-    std::optional<std::string> version = package["version"].As<std::string>();
+    const std::optional<std::string> &version = meta->version;
     if (!version.has_value()) {
         LOG(ERROR) << "count get version val";
         return false;
     }
 
-    const JsonNode &laneInfoNode = package["laneInfo"];
-    std::optional<std::string> compatibleVersion = laneInfoNode["compatibleVersion"].As<std::string>();
+    const std::optional<std::string> &compatibleVersion = meta->compatibleVersion;
     if (!compatibleVersion.has_value()) {
         LOG(ERROR) << "count get compatibleVersion val";
         return false;
     }
 
-    std::optional<std::string> laneCode = laneInfoNode["laneCode"].As<std::string>();
+    const std::optional<std::string> &laneCode = meta->laneCode;
     if (!laneCode.has_value()) {
         LOG(ERROR) << "count get laneCode val";
         return false;
@@ -430,15 +459,15 @@ void ModuleUpdateMain::ParseHmpVersionInfo(std::vector<HmpVersionInfo> &versionI
         hmpWorkDirMap_.emplace(preInfo.name, MODULE_PREINSTALL_DIR);
         return;
     }
-    std::vector<std::string> preVersion {};
-    std::vector<std::string> actVersion {};
+    HmpVersion preVersion {};
+    HmpVersion actVersion {};
     // version: xxx-d01 M.S.F.B
-    if (!ParseVersion(preInfo.version, " ", preVersion)) {
+    if (!ParseHmpVersion(preInfo.version, ' ', preVersion)) {
         LOG(ERROR) << "Parse preVersion failed.";
         return;
     }
 
-    if (!ParseVersion(actInfo.version, " ", actVersion)) {
+    if (!ParseHmpVersion(actInfo.version, ' ', actVersion)) {
         LOG(WARNING) << "Parse actVersion failed.";
         versionInfos.emplace_back(preInfo);
         hmpWorkDirMap_.emplace(preInfo.name, MODULE_PREINSTALL_DIR);
@@ -18,11 +18,13 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
+#include <mutex>
 
 #include "directory_ex.h"
 #include "log/log.h"
 #include "module_constants.h"
 #include "module_error_code.h"
+#include "module_trace.h"
 #include "scope_guard.h"
 #include "unique_fd.h"
 
@@ -31,6 +33,17 @@ namespace SysInstaller {
 using namespace Updater;
 using std::string;
 
+namespace {
+// the result file is shared by the hmps activated in parallel
+std::mutex g_resultFileMutex;
+
+bool VerifyPackageSign(const string &hmpName, const string &file)
+{
+    ModuleTraceSpan span(TRACE_SPAN_SIGN_VERIFY, hmpName);
+    return VerifyModulePackageSign(file) == 0;
+}
+}
+
 ModuleFileRepository::~ModuleFileRepository()
 {
     Clear();
@@ -38,6 +51,7 @@ ModuleFileRepository::~ModuleFileRepository()
 
 void ModuleFileRepository::InitRepository(const string &hmpName, const Timer &timer)
 {
+    ModuleTraceSpan span(TRACE_SPAN_REPOSITORY_SCAN, hmpName);
     string allPath[] = {MODULE_PREINSTALL_DIR, UPDATE_INSTALL_DIR, UPDATE_ACTIVE_DIR};
     auto& fileMap = moduleFileMap_[hmpName];
     for (string &path : allPath) {
@@ -49,7 +63,7 @@ void ModuleFileRepository::InitRepository(const string &hmpName, const Timer &ti
                 continue;
             }
             // verifi zip before open it.
-            if (path != MODULE_PREINSTALL_DIR && VerifyModulePackageSign(file) != 0) {
+            if (path != MODULE_PREINSTALL_DIR && !VerifyPackageSign(hmpName, file)) {
                 LOG(ERROR) << "VerifyModulePackageSign failed of " << file;
                 SaveInstallerResult(path, hmpName, ModuleErrorCode::ERR_VERIFY_FAIL, "verify fail", timer);
                 continue;
@@ -78,6 +92,7 @@ void ModuleFileRepository::SaveInstallerResult(const std::string &fpInfo, const
     }
     LOG(INFO) << "path:" << fpInfo << "hmp:" << hmpName << "result:" << result << "Info:" << resultInfo << "\n";
 
+    std::lock_guard<std::mutex> lock(g_resultFileMutex);
     UniqueFd fd(open(MODULE_RESULT_PATH, O_APPEND | O_RDWR | O_CLOEXEC));
     if (fd.Get() == -1) {
         LOG(ERROR) << "Failed to open file";
@@ -115,31 +130,39 @@ void ModuleFileRepository::ProcessFile(const string &hmpName, const string &path
         }
     }
     LOG(INFO) << "ProcessFile " << file << " successful";
-    fileMap.insert(std::make_pair(path, std::move(*moduleFile)));
+    fileMap.emplace(path, std::move(*moduleFile));
 }
 
-std::unique_ptr<ModuleFile> ModuleFileRepository::GetModuleFile(const std::string &pathPrefix,
-    const string &hmpName) const
+const ModuleFile *ModuleFileRepository::FindModuleFile(const std::string &pathPrefix, const string &hmpName) const
 {
     auto mapIter = moduleFileMap_.find(hmpName);
     if (mapIter == moduleFileMap_.end()) {
         LOG(ERROR) << "Invalid path hmpName= " << hmpName;
         return nullptr;
     }
-    std::unordered_map<std::string, ModuleFile> fileMap = mapIter->second;
+    const std::unordered_map<std::string, ModuleFile> &fileMap = mapIter->second;
     auto fileIter = fileMap.find(pathPrefix);
     if (fileIter == fileMap.end()) {
         LOG(INFO) << hmpName << " not found in " << pathPrefix;
         return nullptr;
     }
-    ModuleFile file = fileIter->second;
-    return std::make_unique<ModuleFile>(std::move(file));
+    return &fileIter->second;
+}
+
+std::unique_ptr<ModuleFile> ModuleFileRepository::GetModuleFile(const std::string &pathPrefix,
+    const string &hmpName) const
+{
+    const ModuleFile *file = FindModuleFile(pathPrefix, hmpName);
+    if (file == nullptr) {
+        return nullptr;
+    }
+    // the copy shares the version info, only path and image stat are duplicated
+    return std::make_unique<ModuleFile>(*file);
 }
 
 bool ModuleFileRepository::IsPreInstalledModule(const ModuleFile &moduleFile) const
 {
-    std::unique_ptr<ModuleFile> preInstalledModule = GetModuleFile(MODULE_PREINSTALL_DIR,
-        moduleFile.GetVersionInfo().hmpName);
+    const ModuleFile *preInstalledModule = FindModuleFile(MODULE_PREINSTALL_DIR, moduleFile.GetVersionInfo().hmpName);
     if (preInstalledModule == nullptr) {
         return false;
     }
@@ -148,13 +171,12 @@ bool ModuleFileRepository::IsPreInstalledModule(const ModuleFile &moduleFile) co
 
 bool ModuleFileRepository::CheckFilePath(const ModuleFile &moduleFile, const string &prefix) const
 {
-    std::unique_ptr<ModuleFile> preInstalledModule = GetModuleFile(MODULE_PREINSTALL_DIR,
-        moduleFile.GetVersionInfo().hmpName);
+    const ModuleFile *preInstalledModule = FindModuleFile(MODULE_PREINSTALL_DIR, moduleFile.GetVersionInfo().hmpName);
     if (preInstalledModule == nullptr) {
         return false;
     }
-    string prePath = preInstalledModule->GetPath();
-    string curPath = moduleFile.GetPath();
+    const string &prePath = preInstalledModule->GetPath();
+    const string &curPath = moduleFile.GetPath();
     return prePath.substr(strlen(MODULE_PREINSTALL_DIR), prePath.length()) ==
         curPath.substr(prefix.length(), curPath.length());
 }
@@ -171,7 +193,7 @@ void ModuleFileRepository::Clear()
     moduleFileMap_.clear();
 }
 
-const std::unordered_map<string, std::unordered_map<string, ModuleFile>> &ModuleFileRepository::GetModuleMap(void)
+const std::unordered_map<string, std::unordered_map<string, ModuleFile>> &ModuleFileRepository::GetModuleMap(void) const
 {
     return moduleFileMap_;
 }
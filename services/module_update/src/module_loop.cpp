@@ -14,6 +14,9 @@
  */
 
 #include "module_loop.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <dirent.h>
 #include <fcntl.h>
 #include <filesystem>
@@ -61,6 +64,8 @@ const size_t LOOP_DEVICE_RETRY_ATTEMPTS = 6u;
 const uint32_t LOOP_BLOCK_SIZE = 4096;
 const std::chrono::milliseconds WAIT_FOR_DEVICE_TIME(50);
 const std::chrono::seconds WAIT_FOR_LOOP_TIME(50);
+constexpr size_t LOOP_POOL_CAPACITY = 128;
+constexpr size_t LOOP_ADD_RETRY_ATTEMPTS = 16;
 }
 
 static bool IsRealPath(std::string path)
@@ -83,25 +88,15 @@ void LoopbackDeviceUniqueFd::MaybeCloseBad() const
     }
 }
 
-bool PreAllocateLoopDevices(const size_t num)
+namespace {
+size_t ScanNextLoopId()
 {
-    if (!WaitForFile(LOOP_CTL_PATH, WAIT_FOR_LOOP_TIME)) {
-        LOG(ERROR) << "loop-control is not ready";
-        return false;
-    }
-    int fd = open(LOOP_CTL_PATH, O_RDWR | O_CLOEXEC);
-    if (fd == -1) {
-        LOG(ERROR) << "Failed to open loop-control";
-        return false;
-    }
-    UniqueFd ctlFd(fd);
-
     bool found = false;
     size_t startId = 0;
     DIR *dir = opendir(BLOCK_DEV_PATH);
     if (dir == nullptr) {
         LOG(ERROR) << "Failed to open " << BLOCK_DEV_PATH;
-        return false;
+        return startId;
     }
     struct dirent *ptr = nullptr;
     while ((ptr = readdir(dir)) != nullptr) {
@@ -122,17 +117,154 @@ bool PreAllocateLoopDevices(const size_t num)
     if (found) {
         startId++;
     }
-    LOG(INFO) << "start id is " << startId;
+    return startId;
+}
+
+/*
+ * loop devices added by this process and not handed out yet. devices are added in one pass
+ * under mutex_ and published through filled_, Take hands them out with a cas on taken_ only.
+ */
+class LoopDevicePool {
+public:
+    static LoopDevicePool &GetInstance()
+    {
+        static LoopDevicePool instance;
+        return instance;
+    }
 
-    for (size_t id = startId; id < num + startId; ++id) {
-        int ret = ioctl(ctlFd.Get(), LOOP_CTL_ADD, id);
-        if (ret < 0 && errno != EEXIST) {
-            LOG(ERROR) << "Failed to add loop device";
+    bool Allocate(size_t num)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!OpenControlFd()) {
             return false;
         }
+        size_t filled = filled_.load(std::memory_order_relaxed);
+        size_t available = filled - std::min(filled, taken_.load(std::memory_order_relaxed));
+        if (available >= num) {
+            return true;
+        }
+        if (!scanned_) {
+            // ids only grow, later allocations continue from here without another readdir
+            nextId_ = ScanNextLoopId();
+            scanned_ = true;
+            LOG(INFO) << "start id is " << nextId_;
+        }
+        size_t endId = nextId_ + num - available;
+        for (; nextId_ < endId; ++nextId_) {
+            int ret = ioctl(ctlFd_.Get(), LOOP_CTL_ADD, nextId_);
+            if (ret < 0 && errno != EEXIST) {
+                LOG(ERROR) << "Failed to add loop device";
+                return false;
+            }
+            // an existing device may be someone else's, only the ones added here are pooled
+            if (ret >= 0 && filled < LOOP_POOL_CAPACITY) {
+                ids_[filled++] = static_cast<int>(nextId_);
+                filled_.store(filled, std::memory_order_release);
+            }
+        }
+        LOG(INFO) << "Pre-allocated " << num << " loopback devices, pooled " << filled - taken_.load();
+        return true;
     }
-    LOG(INFO) << "Pre-allocated " << num << " loopback devices";
-    return true;
+
+    // an unbound device goes back for the next caller, a full pool just forgets it
+    void Release(int id)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        size_t filled = filled_.load(std::memory_order_relaxed);
+        if (filled < LOOP_POOL_CAPACITY) {
+            ids_[filled] = id;
+            filled_.store(filled + 1, std::memory_order_release);
+        }
+    }
+
+    // true for any id the pool ever held, it may be handed out at any time
+    bool IsPooled(int id) const
+    {
+        size_t filled = filled_.load(std::memory_order_acquire);
+        return std::find(ids_.begin(), ids_.begin() + filled, id) != ids_.begin() + filled;
+    }
+
+    // adds a device outside the pool, for when LOOP_CTL_GET_FREE picks a pooled one
+    int AddDevice()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!OpenControlFd()) {
+            return -1;
+        }
+        if (!scanned_) {
+            nextId_ = ScanNextLoopId();
+            scanned_ = true;
+        }
+        for (size_t i = 0; i < LOOP_ADD_RETRY_ATTEMPTS; ++i) {
+            int ret = ioctl(ctlFd_.Get(), LOOP_CTL_ADD, nextId_++);
+            if (ret >= 0) {
+                return ret;
+            }
+            if (errno != EEXIST) {
+                break;
+            }
+        }
+        LOG(ERROR) << "Failed to add loop device err=" << errno;
+        return -1;
+    }
+
+    int Take()
+    {
+        size_t index = taken_.load(std::memory_order_relaxed);
+        do {
+            if (index >= filled_.load(std::memory_order_acquire)) {
+                return -1;
+            }
+        } while (!taken_.compare_exchange_weak(index, index + 1, std::memory_order_acq_rel));
+        return ids_[index];
+    }
+
+    int GetControlFd()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return OpenControlFd() ? ctlFd_.Get() : -1;
+    }
+
+    // a free device stays free until it is bound, lookup and bind go under this lock
+    std::mutex &GetFreeMutex()
+    {
+        return freeMutex_;
+    }
+
+private:
+    LoopDevicePool() = default;
+
+    bool OpenControlFd()
+    {
+        if (ctlFd_.Get() != -1) {
+            return true;
+        }
+        if (!WaitForFile(LOOP_CTL_PATH, WAIT_FOR_LOOP_TIME)) {
+            LOG(ERROR) << "loop-control is not ready";
+            return false;
+        }
+        ctlFd_ = UniqueFd(open(LOOP_CTL_PATH, O_RDWR | O_CLOEXEC));
+        if (ctlFd_.Get() == -1) {
+            LOG(ERROR) << "Failed to open loop-control";
+            return false;
+        }
+        return true;
+    }
+
+    std::mutex mutex_;
+    std::mutex freeMutex_;
+    UniqueFd ctlFd_;
+    bool scanned_ = false;
+    size_t nextId_ = 0;
+    std::array<int, LOOP_POOL_CAPACITY> ids_ {};
+    std::atomic<size_t> filled_ {0};
+    std::atomic<size_t> taken_ {0};
+};
+}
+
+bool PreAllocateLoopDevices(const size_t num)
+{
+    return LoopDevicePool::GetInstance().Allocate(num);
 }
 
 bool ConfigureReadAhead(const string &devicePath)
@@ -222,6 +354,8 @@ bool SetLoopDeviceStatus(const int deviceFd, const int targetFd, const struct lo
     ret = ioctl(deviceFd, LOOP_SET_STATUS64, li);
     if (ret < 0) {
         LOG(ERROR) << "Failed to set loop status err=" << errno;
+        // bound above, so the caller can drop the device without clearing it
+        (void)ioctl(deviceFd, LOOP_CLR_FD);
         return false;
     }
     ret = ioctl(deviceFd, BLKFLSBUF, 0);
@@ -288,47 +422,88 @@ std::unique_ptr<LoopbackDeviceUniqueFd> WaitForDevice(const int num)
 
     UniqueFd sysfsFd;
     for (size_t i = 0; i < LOOP_DEVICE_RETRY_ATTEMPTS; ++i) {
+        bool nodeExists = false;
         for (const auto &device : candidateDevices) {
             string realPath = GetRealPath(device);
             if (realPath.empty()) {
                 continue;
             }
+            nodeExists = true;
             sysfsFd = UniqueFd(open(realPath.c_str(), O_RDWR | O_CLOEXEC));
             if (sysfsFd.Get() != -1) {
                 return std::make_unique<LoopbackDeviceUniqueFd>(std::move(sysfsFd), realPath);
             }
         }
-        LOG(WARNING) << "Loopback device " << num << " not ready. Waiting 50ms...";
-        usleep(std::chrono::duration_cast<std::chrono::microseconds>(WAIT_FOR_DEVICE_TIME).count());
+        // a missing node wakes us as soon as ueventd creates it, one that can't be opened yet waits the full slice
+        if (nodeExists) {
+            LOG(WARNING) << "Loopback device " << num << " not ready. Waiting 50ms...";
+            usleep(std::chrono::duration_cast<std::chrono::microseconds>(WAIT_FOR_DEVICE_TIME).count());
+        } else {
+            (void)WaitForFiles(candidateDevices, WAIT_FOR_DEVICE_TIME);
+        }
     }
     LOG(ERROR) << "Failed to open loopback device " << num;
     return nullptr;
 }
 
+bool IsLoopDeviceBound(const int deviceFd)
+{
+    struct loop_info64 li;
+    return ioctl(deviceFd, LOOP_GET_STATUS64, &li) == 0;
+}
+
 std::unique_ptr<LoopbackDeviceUniqueFd> CreateLoopDevice(
     const string &target, const uint32_t imageOffset, const uint32_t imageSize)
 {
-    UniqueFd ctlFd(open(LOOP_CTL_PATH, O_RDWR | O_CLOEXEC));
-    if (ctlFd.Get() == -1) {
-        LOG(ERROR) << "Failed to open loop-control";
-        return nullptr;
-    }
-    static std::mutex mlock;
-    std::lock_guard lock(mlock);
-    int num = ioctl(ctlFd.Get(), LOOP_CTL_GET_FREE);
-    if (num < 0) {
-        LOG(ERROR) << "Failed to get free loop device err=" << errno;
-        return nullptr;
+    auto &pool = LoopDevicePool::GetInstance();
+    std::unique_ptr<LoopbackDeviceUniqueFd> loopDevice = nullptr;
+    int num = pool.Take();
+    if (num >= 0) {
+        LOG(INFO) << "Get pooled loop device num " << num;
+        loopDevice = WaitForDevice(num);
+        if (loopDevice != nullptr && IsLoopDeviceBound(loopDevice->Get())) {
+            // another process bound it after it was added, it is not ours to clear
+            LOG(WARNING) << "Pooled loop device " << num << " is in use, fall back to a free one";
+            (void)close(loopDevice->deviceFd.Release());
+            loopDevice = nullptr;
+        }
+        if (loopDevice != nullptr && !SetUpLoopDevice(loopDevice->deviceFd.Get(), target, imageOffset, imageSize)) {
+            // nothing of ours is bound, a LOOP_CLR_FD here could only hit another process
+            LOG(WARNING) << "Pooled loop device " << num << " is not usable, fall back to a free one";
+            (void)close(loopDevice->deviceFd.Release());
+            loopDevice = nullptr;
+            pool.Release(num);
+        }
     }
-    LOG(INFO) << "Get free loop device num " << num;
-    std::unique_ptr<LoopbackDeviceUniqueFd> loopDevice = WaitForDevice(num);
     if (loopDevice == nullptr) {
-        LOG(ERROR) << "Failed to create loop device " << num;
-        return nullptr;
-    }
-    if (!SetUpLoopDevice(loopDevice->deviceFd.Get(), target, imageOffset, imageSize)) {
-        LOG(ERROR) << "Failed to configure device";
-        return nullptr;
+        int ctlFd = pool.GetControlFd();
+        if (ctlFd == -1) {
+            return nullptr;
+        }
+        std::lock_guard<std::mutex> lock(pool.GetFreeMutex());
+        num = ioctl(ctlFd, LOOP_CTL_GET_FREE);
+        if (num < 0) {
+            LOG(ERROR) << "Failed to get free loop device err=" << errno;
+            return nullptr;
+        }
+        if (pool.IsPooled(num)) {
+            LOG(INFO) << "Free loop device " << num << " is pooled, add a new one";
+            num = pool.AddDevice();
+            if (num < 0) {
+                return nullptr;
+            }
+        }
+        LOG(INFO) << "Get free loop device num " << num;
+        loopDevice = WaitForDevice(num);
+        if (loopDevice == nullptr) {
+            LOG(ERROR) << "Failed to create loop device " << num;
+            return nullptr;
+        }
+        if (!SetUpLoopDevice(loopDevice->deviceFd.Get(), target, imageOffset, imageSize)) {
+            LOG(ERROR) << "Failed to configure device";
+            (void)close(loopDevice->deviceFd.Release());
+            return nullptr;
+        }
     }
     if (!ConfigureReadAhead(loopDevice->name)) {
         LOG(ERROR) << "Failed to configure read ahead";
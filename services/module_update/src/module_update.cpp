@@ -15,6 +15,7 @@
 
 #include "module_update.h"
 
+#include <algorithm>
 #include <chrono>
 #include <sys/mount.h>
 #include <sys/stat.h>
@@ -28,6 +29,7 @@
 #include "module_error_code.h"
 #include "module_file_repository.h"
 #include "module_loop.h"
+#include "module_trace.h"
 #include "module_update_task.h"
 #include "module_utils.h"
 #include "scope_guard.h"
@@ -46,6 +48,14 @@ using std::string;
 namespace {
 constexpr mode_t MOUNT_POINT_MODE = 0755;
 constexpr int32_t LOOP_DEVICE_SETUP_ATTEMPTS = 3;
+constexpr std::chrono::seconds WAIT_FOR_DEVICE_TIMEOUT(3);
+
+// one worker per cpu, never more than there are hmps to activate
+size_t GetActivateThreadNum(size_t hmpNum)
+{
+    size_t cpuNum = std::max(std::thread::hardware_concurrency(), 1U);
+    return std::max<size_t>(std::min(cpuNum, hmpNum), 1);
+}
 
 bool CreateLoopDevice(const string &path, const ImageStat &imageStat, Loop::LoopbackDeviceUniqueFd &loopbackDevice)
 {
@@ -118,10 +128,15 @@ bool CheckModulePackage(const std::string &mountPoint, const ModuleFile &moduleF
 bool VerifyAndCreateDm(ModuleFile &moduleFile, string &blockDevice)
 {
     LOG(ERROR) << "Verify and create dm.";
-    if (!moduleFile.VerifyModuleVerity()) {
-        LOG(ERROR) << "verify image failed of " << moduleFile.GetPath();
-        return false;
+    const std::string &hmpName = moduleFile.GetVersionInfo().hmpName;
+    {
+        ModuleTraceSpan span(TRACE_SPAN_HVB_VERIFY, hmpName);
+        if (!moduleFile.VerifyModuleVerity()) {
+            LOG(ERROR) << "verify image failed of " << moduleFile.GetPath();
+            return false;
+        }
     }
+    ModuleTraceSpan span(TRACE_SPAN_DM_CREATE, hmpName);
     if (!CreateDmDevice(moduleFile, blockDevice)) {
         LOG(ERROR) << "Could not create dm-verity device on " << blockDevice;
         Loop::ClearDmLoopDevice(blockDevice, false);
@@ -137,29 +152,29 @@ ModuleUpdate &ModuleUpdate::GetInstance()
     return instance;
 }
 
-std::unique_ptr<ModuleFile> ModuleUpdate::GetLatestUpdateModulePackage(const string &hmpName)
+const ModuleFile *ModuleUpdate::GetLatestUpdateModulePackage(const ModuleFileRepository &repository,
+    const string &hmpName, string &modulePath)
 {
-    std::unique_ptr<ModuleFile> activeModuleFile = repository_.GetModuleFile(UPDATE_ACTIVE_DIR, hmpName);
-    std::unique_ptr<ModuleFile> updateModuleFile = repository_.GetModuleFile(UPDATE_INSTALL_DIR, hmpName);
-    std::unique_ptr<ModuleFile> ret = nullptr;
+    const ModuleFile *activeModuleFile = repository.FindModuleFile(UPDATE_ACTIVE_DIR, hmpName);
+    const ModuleFile *updateModuleFile = repository.FindModuleFile(UPDATE_INSTALL_DIR, hmpName);
     if (updateModuleFile != nullptr) {
         if (activeModuleFile == nullptr || ModuleFile::CompareVersion(*updateModuleFile, *activeModuleFile)) {
-            string updatePath = updateModuleFile->GetPath();
+            const string &updatePath = updateModuleFile->GetPath();
             string activePath = UPDATE_ACTIVE_DIR +
                 updatePath.substr(strlen(UPDATE_INSTALL_DIR), updatePath.length());
             if (!StageUpdateModulePackage(updatePath, activePath)) {
-                return ret;
+                return nullptr;
             }
-            updateModuleFile->SetPath(activePath);
-            ret = std::move(updateModuleFile);
             LOG(INFO) << "add updateModuleFile " << updatePath;
+            modulePath = std::move(activePath);
+            return updateModuleFile;
         }
     }
-    if (ret == nullptr && activeModuleFile != nullptr) {
+    if (activeModuleFile != nullptr) {
         LOG(INFO) << "add activeModuleFile " << activeModuleFile->GetPath();
-        ret = std::move(activeModuleFile);
+        modulePath = activeModuleFile->GetPath();
     }
-    return ret;
+    return activeModuleFile;
 }
 
 bool ModuleUpdate::CheckMountComplete(const string &hmpName) const
@@ -168,7 +183,8 @@ bool ModuleUpdate::CheckMountComplete(const string &hmpName) const
     return CheckPathExists(path);
 }
 
-void ModuleUpdate::ProcessHmpFile(const string &hmpFile, const ModuleUpdateStatus &status, const Timer &timer)
+void ModuleUpdate::ProcessHmpFile(ModuleActivateContext &context, const string &hmpFile,
+    const ModuleUpdateStatus &status, const Timer &timer)
 {
     LOG(INFO) << "process hmp file=" << hmpFile;
     std::unique_ptr<ModuleFile> moduleFile = ModuleFile::Open(hmpFile);
@@ -180,38 +196,37 @@ void ModuleUpdate::ProcessHmpFile(const string &hmpFile, const ModuleUpdateStatu
         LOG(INFO) << "Check mount complete, hmpName=" << status.hmpName;
         return;
     }
-    repository_.InitRepository(status.hmpName, timer);
-    PrepareModuleFileList(status);
+    context.repository.InitRepository(status.hmpName, timer);
+    PrepareModuleFileList(context, status);
 }
 
 bool ModuleUpdate::DoModuleUpdate(ModuleUpdateStatus &status)
 {
     LOG(INFO) << "enter domoduleupdate";
+    ModuleTraceSpan span(TRACE_SPAN_ACTIVATE, status.hmpName);
     Timer timer;
     std::string hmpPackagePath = std::string(MODULE_PREINSTALL_DIR) + "/" + status.hmpName;
     LOG(INFO) << "DoModuleUpdate hmp package path=" << hmpPackagePath;
     std::vector<std::string> files;
     GetDirFiles(hmpPackagePath, files);
-    ON_SCOPE_EXIT(clear) {
-        repository_.Clear();
-        moduleFileList_.clear();
-    };
+    // released when this activation returns, nothing is shared with other hmps
+    ModuleActivateContext context;
     for (auto &file : files) {
         std::string hmpPackage = GetFileName(file);
         if (!CheckFileSuffix(file, MODULE_PACKAGE_SUFFIX) || hmpPackage.empty()) {
             continue;
         }
-        ProcessHmpFile(file, status, timer);
+        ProcessHmpFile(context, file, status, timer);
     }
-    if (moduleFileList_.size() != 1) {
-        LOG(INFO) << status.hmpName << " module size is invalid: " << moduleFileList_.size();
+    if (context.moduleFileList.size() != 1) {
+        LOG(INFO) << status.hmpName << " module size is invalid: " << context.moduleFileList.size();
         return false;
     }
-    if (!Loop::PreAllocateLoopDevices(moduleFileList_.size())) {
+    if (!Loop::PreAllocateLoopDevices(context.moduleFileList.size())) {
         LOG(ERROR) << "Failed to pre allocate loop devices, hmp package name=" << status.hmpName;
         return false;
     }
-    if (!ActivateModules(status, timer)) {
+    if (!ActivateModules(context, status, timer)) {
         LOG(ERROR) << "Failed to activate modules, hmp package name=" << status.hmpName;
         return false;
     }
@@ -223,9 +238,11 @@ void ModuleUpdate::CheckModuleUpdate()
 {
     InitUpdaterLogger("CheckModuleUpdate", MODULE_UPDATE_LOG_FILE, "", "");
     LOG(INFO) << "CheckModuleUpdate begin";
+    ModuleTrace::GetInstance().Enable();
     Timer timer;
     std::vector<std::string> files;
     std::unordered_set<std::string> hmpNameSet;
+    std::unordered_set<std::string> trainHmpNameSet;
     GetDirFiles(MODULE_PREINSTALL_DIR, files);
     for (auto &file : files) {
         if (!CheckFileSuffix(file, MODULE_PACKAGE_SUFFIX)) {
@@ -239,32 +256,48 @@ void ModuleUpdate::CheckModuleUpdate()
         if (hmpName.empty()) {
             continue;
         }
-        hmpNameSet.emplace(hmpName);
+        if (moduleFile->GetVersionInfo().type == HMP_TRAIN_TYPE) {
+            trainHmpNameSet.emplace(hmpName);
+        } else {
+            hmpNameSet.emplace(hmpName);
+        }
+    }
+    // one pass for all hmps, each activation then takes its device from the pool
+    if (!Loop::PreAllocateLoopDevices(hmpNameSet.size() + trainHmpNameSet.size())) {
+        LOG(WARNING) << "Failed to pre allocate loop devices for all hmps";
     }
     auto &instance = ModuleUpdateTaskManager::GetInstance();
-    instance.Start();
+    instance.Start(GetActivateThreadNum(std::max(hmpNameSet.size(), trainHmpNameSet.size())));
     ON_SCOPE_EXIT(clear) {
         instance.ClearTask();
         instance.Stop();
         LOG(INFO) << "CheckModuleUpdate done, duration=" << timer;
+        (void)ModuleTrace::GetInstance().Export(MODULE_TRACE_PATH);
+        ModuleTrace::GetInstance().Disable();
+        ModuleTrace::GetInstance().Clear();
         if (!ForceRemoveDirectory(UPDATE_INSTALL_DIR)) {
             LOG(ERROR) << "Failed to remove " << UPDATE_INSTALL_DIR << " err=" << errno;
         }
     };
-    for (auto &hmpName : hmpNameSet) {
+    // a train hmp is mounted on the module root itself, it has to be in place before others mount below it
+    for (auto &hmpName : trainHmpNameSet) {
         instance.AddTask(hmpName);
     }
-    while (instance.GetCurTaskNum() != 0) {
-        usleep(3000); // 3000: 3ms
+    instance.WaitAllTasks();
+    for (auto &hmpName : hmpNameSet) {
+        if (trainHmpNameSet.find(hmpName) == trainHmpNameSet.end()) {
+            instance.AddTask(hmpName);
+        }
     }
+    instance.WaitAllTasks();
 }
 
-bool ModuleUpdate::CheckRevert(const std::string &hmpName)
+bool ModuleUpdate::CheckRevert(const ModuleFileRepository &repository, const std::string &hmpName)
 {
     if (!CheckPathExists(std::string(UPDATE_BACKUP_DIR) + "/" + hmpName)) {
         return false;
     }
-    auto &moduleMap = repository_.GetModuleMap();
+    auto &moduleMap = repository.GetModuleMap();
     for (const auto &[key, value] : moduleMap) {
         if (key != hmpName) {
             continue;
@@ -278,19 +311,21 @@ bool ModuleUpdate::CheckRevert(const std::string &hmpName)
     return false;
 }
 
-void ModuleUpdate::PrepareModuleFileList(const ModuleUpdateStatus &status)
+void ModuleUpdate::PrepareModuleFileList(ModuleActivateContext &context, const ModuleUpdateStatus &status)
 {
-    std::unique_ptr<ModuleFile> systemModuleFile = repository_.GetModuleFile(MODULE_PREINSTALL_DIR, status.hmpName);
+    // the repository keeps its files, only the one chosen for mounting is copied into the list
+    const ModuleFile *systemModuleFile = context.repository.FindModuleFile(MODULE_PREINSTALL_DIR, status.hmpName);
     if (systemModuleFile == nullptr) {
         LOG(ERROR) << "Failed to get preinstalled hmp " << status.hmpName;
         return;
     }
-    std::unique_ptr<ModuleFile> latestModuleFile = GetLatestUpdateModulePackage(status.hmpName);
+    string latestPath;
+    const ModuleFile *latestModuleFile = GetLatestUpdateModulePackage(context.repository, status.hmpName, latestPath);
     if (latestModuleFile != nullptr && ModuleFile::CompareVersion(*latestModuleFile, *systemModuleFile)) {
-        moduleFileList_.emplace_back(std::move(*latestModuleFile));
+        context.moduleFileList.emplace_back(*latestModuleFile).SetPath(latestPath);
     } else {
-        moduleFileList_.emplace_back(std::move(*systemModuleFile));
-        if (CheckRevert(status.hmpName)) {
+        context.moduleFileList.emplace_back(*systemModuleFile);
+        if (CheckRevert(context.repository, status.hmpName)) {
             LOG(ERROR) << "some error happened, revert.";
             NotifyBmsRevert(status.hmpName, true);
             Revert(status.hmpName, true);
@@ -302,19 +337,19 @@ void ModuleUpdate::PrepareModuleFileList(const ModuleUpdateStatus &status)
     }
 }
 
-bool ModuleUpdate::ActivateModules(ModuleUpdateStatus &status, const Timer &timer)
+bool ModuleUpdate::ActivateModules(ModuleActivateContext &context, ModuleUpdateStatus &status, const Timer &timer)
 {
     // size = 1
-    for (auto &moduleFile : moduleFileList_) {
+    for (auto &moduleFile : context.moduleFileList) {
         if (!moduleFile.GetImageStat().has_value()) {
             LOG(INFO) << moduleFile.GetPath() << " is empty module package";
             continue;
         }
-        status.isPreInstalled = repository_.IsPreInstalledModule(moduleFile);
+        status.isPreInstalled = context.repository.IsPreInstalledModule(moduleFile);
         status.isAllMountSuccess = MountModulePackage(moduleFile, !status.isPreInstalled);
         if (!status.isAllMountSuccess) {
             LOG(ERROR) << "Failed to mount module package " << moduleFile.GetPath();
-            repository_.SaveInstallerResult(moduleFile.GetPath(), status.hmpName,
+            context.repository.SaveInstallerResult(moduleFile.GetPath(), status.hmpName,
                 ERR_INSTALL_FAIL, "mount fail", timer);
         }
         // bugfix: when sise = 1, for() find the second item
@@ -327,11 +362,7 @@ bool ModuleUpdate::ActivateModules(ModuleUpdateStatus &status, const Timer &time
 
 void ModuleUpdate::WaitDevice(const std::string &blockDevice) const
 {
-    const int waitTime = 150; // wait max 3s
-    int time = 0;
-    while (!CheckPathExists(blockDevice) && time++ < waitTime) {
-        usleep(20000); // 20000: 20ms
-    }
+    (void)WaitForFile(blockDevice, WAIT_FOR_DEVICE_TIMEOUT);
 }
 
 bool ModuleUpdate::VerifyImageAndCreateDm(ModuleFile &moduleFile, bool mountOnVerity, string &blockDevice)
@@ -380,19 +411,29 @@ bool ModuleUpdate::MountModulePackage(ModuleFile &moduleFile, const bool mountOn
     }
     const string &fpInfo = ExtractFilePath(moduleFile.GetPath()) + IMG_FILE_NAME;
     const ImageStat &imageStat = moduleFile.GetImageStat().value();
+    const string &hmpName = moduleFile.GetVersionInfo().hmpName;
     Loop::LoopbackDeviceUniqueFd loopbackDevice;
-    if (!CreateLoopDevice(fpInfo, imageStat, loopbackDevice)) {
-        LOG(ERROR) << "Could not create loop device for " << fpInfo;
-        return false;
+    {
+        ModuleTraceSpan span(TRACE_SPAN_LOOP_CREATE, hmpName);
+        if (!CreateLoopDevice(fpInfo, imageStat, loopbackDevice)) {
+            LOG(ERROR) << "Could not create loop device for " << fpInfo;
+            return false;
+        }
     }
     LOG(INFO) << "Loopback device created: " << loopbackDevice.name << " fsType=" << imageStat.fsType;
     string blockDevice = loopbackDevice.name;
     if (!VerifyImageAndCreateDm(moduleFile, mountOnVerity, blockDevice)) {
         return false;
     }
-    WaitDevice(blockDevice);
+    {
+        ModuleTraceSpan span(TRACE_SPAN_DEVICE_WAIT, hmpName);
+        WaitDevice(blockDevice);
+    }
     uint32_t mountFlags = MS_NOATIME | MS_NODEV | MS_DIRSYNC | MS_RDONLY;
-    ret = mount(blockDevice.c_str(), mountPoint.c_str(), imageStat.fsType, mountFlags, nullptr);
+    {
+        ModuleTraceSpan span(TRACE_SPAN_MOUNT, hmpName);
+        ret = mount(blockDevice.c_str(), mountPoint.c_str(), imageStat.fsType, mountFlags, nullptr);
+    }
     if (ret != 0) {
         LOG(ERROR) << "Mounting failed for module package " << fpInfo << " errno:" << errno;
         Loop::ClearDmLoopDevice(blockDevice, true);
@@ -29,6 +29,7 @@ void TaskCallback(ModuleUpdateTask task)
     status.hmpName = hmpName;
     auto ret = ModuleUpdate::GetInstance().DoModuleUpdate(status);
     ModuleUpdateTaskManager::GetInstance().SetTaskResult(ret);
+    ModuleUpdateTaskManager::GetInstance().FinishTask();
 }
 }
 
@@ -49,7 +50,9 @@ std::string &ModuleUpdateTask::GetHmpName()
 
 void ModuleUpdateTaskManager::SetTaskResult(bool result)
 {
-    taskResult_ = taskResult_ && result;
+    if (!result) {
+        taskResult_ = false;
+    }
 }
 
 bool ModuleUpdateTaskManager::GetTaskResult()
@@ -69,6 +72,10 @@ bool ModuleUpdateTaskManager::AddTask(const std::string &hmpName)
         LOG(ERROR) << "add task failed:" << taskNum_;
         return false;
     }
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex_);
+        pendingTaskNum_++;
+    }
     pool_.AddTask([hmpName] {
         ModuleUpdateTask task = ModuleUpdateTask(hmpName);
         TaskCallback(task);
@@ -77,6 +84,20 @@ bool ModuleUpdateTaskManager::AddTask(const std::string &hmpName)
     return true;
 }
 
+void ModuleUpdateTaskManager::FinishTask()
+{
+    std::lock_guard<std::mutex> lock(pendingMutex_);
+    if (pendingTaskNum_ > 0 && --pendingTaskNum_ == 0) {
+        pendingCond_.notify_all();
+    }
+}
+
+void ModuleUpdateTaskManager::WaitAllTasks()
+{
+    std::unique_lock<std::mutex> lock(pendingMutex_);
+    pendingCond_.wait(lock, [this] { return pendingTaskNum_ == 0; });
+}
+
 size_t ModuleUpdateTaskManager::GetCurTaskNum()
 {
     return pool_.GetCurTaskNum();
@@ -87,9 +108,10 @@ void ModuleUpdateTaskManager::Stop()
     pool_.Stop();
 }
 
-void ModuleUpdateTaskManager::Start()
+void ModuleUpdateTaskManager::Start(size_t threadNum)
 {
-    pool_.Start(1);
+    LOG(INFO) << "module update task thread num=" << threadNum;
+    pool_.Start(static_cast<int>(threadNum));
     pool_.SetMaxTaskNum(MAX_TASK_NUM);
     taskNum_ = 0;
 }
@@ -20,12 +20,17 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <vector>
 
 #ifdef SUPPORT_HVB
 #include "hvb.h"
 #endif
 #include "module_zip_helper.h"
+namespace Updater {
+class JsonNode;
+}
 namespace OHOS {
 namespace SysInstaller {
 namespace {
@@ -41,13 +46,31 @@ constexpr const char *HMP_API_VERSION = "apiVersion";
 constexpr const char *HMP_SA_SDK_VERSION = "saSdkVersion";
 constexpr const char *HMP_MODULE_INFO = "moduleInfo";
 
+constexpr size_t HMP_VERSION_NUMBER_SIZE = 4;
+
+// "<prefix><split>M.S.F.B" parsed once, prefix views the parsed string which has to outlive it
+struct HmpVersion {
+    std::string_view prefix {};
+    int32_t number[HMP_VERSION_NUMBER_SIZE] {};
+    bool valid {false};
+
+    bool IsSamePrefix(const HmpVersion &other) const
+    {
+        return prefix == other.prefix;
+    }
+};
+
 bool ExtractZipFile(ModuleZipHelper &helper, const std::string &fpInfo, std::string &buf);
 bool ParseVersion(const std::string &version, const std::string &split, std::vector<std::string> &versionVec);
 bool CompareHmpVersion(const std::vector<std::string> &smallVersion, const std::vector<std::string> &bigVersion);
 bool CompareSaSdkVersion(const std::vector<std::string> &smallVersion, const std::vector<std::string> &bigVersion);
+bool ParseHmpVersion(std::string_view version, char split, HmpVersion &hmpVersion);
+bool CompareHmpVersion(const HmpVersion &smallVersion, const HmpVersion &bigVersion);
+bool CompareSaSdkVersion(const HmpVersion &smallVersion, const HmpVersion &bigVersion);
 #ifdef __cplusplus
 extern "C" {
 #endif
+// the installer serializes calls made from its extraction workers
 int32_t VerifyModulePackageSign(const std::string &fpInfo);
 #ifdef __cplusplus
 }
@@ -90,6 +113,8 @@ struct ModulePackageInfo {
     std::unordered_map<std::string, ModuleInfo> moduleMap {};
 };
 
+bool ParseModuleInfo(const Updater::JsonNode &root, ModulePackageInfo &versionInfo);
+
 struct ImageStat {
     uint32_t imageOffset;
     uint32_t imageSize;
@@ -103,14 +128,25 @@ public:
     ModuleFile(const std::string &modulePath,
                const ModulePackageInfo &versionInfo,
                const std::optional<ImageStat> &imageStat)
+        : ModuleFile(modulePath, std::make_shared<const ModulePackageInfo>(versionInfo), imageStat) {}
+    // copies of a module file share one immutable version info
+    ModuleFile(const std::string &modulePath,
+               std::shared_ptr<const ModulePackageInfo> versionInfo,
+               const std::optional<ImageStat> &imageStat)
         : modulePath_(modulePath),
-          versionInfo_(versionInfo),
-          imageStat_(imageStat) {}
+          versionInfo_(std::move(versionInfo)),
+          imageStat_(imageStat)
+    {
+        // version: xxx-d01 M.S.F.B, an invalid one is reported when compared.
+        // the prefix views versionInfo_, which copies and moves share and never modify
+        (void)ParseHmpVersion(versionInfo_->version, ' ', hmpVersion_);
+    }
     virtual ~ModuleFile();
-    ModuleFile(const ModuleFile&) = default;
-    ModuleFile& operator=(const ModuleFile&) = default;
-    ModuleFile(ModuleFile&&) = default;
-    ModuleFile& operator=(ModuleFile&&) = default;
+    // verified data is owned by one file, a copy has to verify again
+    ModuleFile(const ModuleFile &other);
+    ModuleFile& operator=(const ModuleFile &other);
+    ModuleFile(ModuleFile &&other) noexcept;
+    ModuleFile& operator=(ModuleFile &&other) noexcept;
 
     const std::string &GetPath() const
     {
@@ -118,7 +154,11 @@ public:
     }
     const ModulePackageInfo &GetVersionInfo() const
     {
-        return versionInfo_;
+        return *versionInfo_;
+    }
+    const HmpVersion &GetHmpVersion() const
+    {
+        return hmpVersion_;
     }
     const std::optional<ImageStat> &GetImageStat() const
     {
@@ -140,7 +180,8 @@ public:
 
 private:
     std::string modulePath_;
-    ModulePackageInfo versionInfo_;
+    std::shared_ptr<const ModulePackageInfo> versionInfo_;
+    HmpVersion hmpVersion_;
     std::optional<ImageStat> imageStat_;
 
 #ifdef SUPPORT_HVB
@@ -18,6 +18,29 @@
 
 #include "hvb_ops.h"
 
+#ifdef __cplusplus
+#include <cstdint>
+#include <string>
+
+#include "unique_fd.h"
+
+namespace OHOS {
+namespace SysInstaller {
+// state of one hvb verification, reached from hvb_ops.user_data in every read callback
+struct ModuleHvbContext {
+    struct hvb_ops ops {};
+    std::string partition;
+    UniqueFd fd;
+    int64_t imageOffset = 0;
+    int64_t imageSize = 0;
+};
+
+// fills context.ops with the module callbacks and points user_data at context
+void ModuleHvbInitContext(ModuleHvbContext &context);
+} // namespace SysInstaller
+} // namespace OHOS
+#endif
+
 #ifdef __cplusplus
 #if __cplusplus
 extern "C" {
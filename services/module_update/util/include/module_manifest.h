@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef SYS_INSTALLER_MODULE_MANIFEST_H
+#define SYS_INSTALLER_MODULE_MANIFEST_H
+
+#include <cstdint>
+#include <string>
+
+#include "module_pack_info_cache.h"
+#include "module_zip_helper.h"
+
+namespace OHOS {
+namespace SysInstaller {
+/*
+ * pack.info.bin, a precompiled pack.info stored next to module_info.zip.
+ * layout: header | modules | sa list | bundle list | string table, all fields 4 byte aligned
+ * and in device byte order so the file can be used straight from an mmap.
+ * pack.info stays the source of truth, the manifest is only used while its recorded
+ * crc and size match the pack.info entry in the zip central directory.
+ * the crc is no integrity check, so only manifests built into the read only preinstall
+ * partition are trusted, see tools/module_update_tool/module_manifest.gni.
+ * the device only reads manifests, gen_module_manifest.py is the one writer.
+ */
+constexpr uint32_t MODULE_MANIFEST_MAGIC = 0x4D504D48; // "HMPM"
+constexpr uint16_t MODULE_MANIFEST_VERSION = 1;
+constexpr uint32_t MODULE_MANIFEST_NO_STR = 0xFFFFFFFF;
+
+struct ModuleManifestStr {
+    uint32_t offset = MODULE_MANIFEST_NO_STR; // into the string table
+    uint32_t size = 0;
+};
+
+enum ModuleManifestField : uint32_t {
+    MANIFEST_TYPE = 0,
+    MANIFEST_PACKAGE_TYPE,
+    MANIFEST_IMAGE_HASH,
+    MANIFEST_NAME,
+    MANIFEST_VERSION,
+    MANIFEST_API_VERSION,
+    MANIFEST_SA_SDK_VERSION,
+    MANIFEST_COMPATIBLE_VERSION,
+    MANIFEST_LANE_CODE,
+    MANIFEST_HMP_NAME,
+    MANIFEST_HMP_VERSION,
+    MANIFEST_HMP_DISPLAY_VERSION,
+    MANIFEST_HMP_SA_SDK_VERSION,
+    MANIFEST_HMP_TYPE,
+    MANIFEST_FIELD_NUM,
+};
+
+struct ModuleManifestHeader {
+    uint32_t magic = MODULE_MANIFEST_MAGIC;
+    uint16_t version = MODULE_MANIFEST_VERSION;
+    uint16_t headerSize = sizeof(ModuleManifestHeader);
+    uint32_t fileSize = 0;
+    uint32_t checksum = 0; // fnv-1a of everything after the header
+    uint32_t packInfoCrc = 0;
+    uint32_t packInfoSize = 0;
+    uint32_t isModuleInfoValid = 0;
+    int32_t hmpApiVersion = -1;
+    uint32_t moduleNum = 0;
+    uint32_t saNum = 0;
+    uint32_t bundleNum = 0;
+    uint32_t stringsSize = 0;
+    ModuleManifestStr fields[MANIFEST_FIELD_NUM] {};
+};
+
+struct ModuleManifestModule {
+    ModuleManifestStr name;
+    uint32_t saBegin = 0;
+    uint32_t saNum = 0;
+    uint32_t bundleBegin = 0;
+    uint32_t bundleNum = 0;
+};
+
+struct ModuleManifestSa {
+    ModuleManifestStr name;
+    int32_t saId = 0;
+    uint32_t apiVersion = 0;
+    uint32_t versionCode = 0;
+    uint32_t patchVersion = 0;
+};
+
+struct ModuleManifestBundle {
+    ModuleManifestStr name;
+    ModuleManifestStr version;
+};
+
+bool LoadModuleManifest(const std::string &manifestPath, const ModuleZipEntry &packInfo, ModulePackInfoMeta &meta);
+// loads pack.info.bin next to zipPath, only for a preinstalled package on a read only partition
+bool LoadTrustedModuleManifest(const std::string &zipPath, const ModuleZipEntry &packInfo, ModulePackInfoMeta &meta);
+} // namespace SysInstaller
+} // namespace OHOS
+#endif // SYS_INSTALLER_MODULE_MANIFEST_H
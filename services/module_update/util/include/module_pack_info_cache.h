@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef SYS_INSTALLER_MODULE_PACK_INFO_CACHE_H
+#define SYS_INSTALLER_MODULE_PACK_INFO_CACHE_H
+
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <sys/types.h>
+#include <unordered_map>
+
+#include "module_file.h"
+
+namespace OHOS {
+namespace SysInstaller {
+// everything the install path needs from pack.info, parsed once per package file
+struct ModulePackInfoMeta {
+    bool isModuleInfoValid = false;
+    ModulePackageInfo moduleInfo {};
+    std::optional<std::string> type;
+    std::optional<std::string> packageType;
+    std::optional<std::string> imageHash;
+    std::optional<std::string> name;
+    std::optional<std::string> version;
+    std::optional<std::string> apiVersion;
+    std::optional<std::string> saSdkVersion;
+    std::optional<std::string> compatibleVersion;
+    std::optional<std::string> laneCode;
+};
+
+// parses pack.info json into the cached form, always succeeds, missing fields stay empty
+std::shared_ptr<ModulePackInfoMeta> ParsePackInfoMeta(const std::string &packInfo);
+
+class ModulePackInfoCache {
+public:
+    static ModulePackInfoCache &GetInstance();
+    std::shared_ptr<const ModulePackInfoMeta> Get(const std::string &zipPath);
+    void Invalidate(const std::string &zipPath);
+    void Clear();
+
+private:
+    struct FileStamp {
+        dev_t dev = 0;
+        ino_t ino = 0;
+        off_t size = 0;
+        int64_t mtimeSec = 0;
+        int64_t mtimeNsec = 0;
+        // unlike mtime it can not be set back by the writer
+        int64_t ctimeSec = 0;
+        int64_t ctimeNsec = 0;
+
+        bool operator==(const FileStamp &other) const
+        {
+            return dev == other.dev && ino == other.ino && size == other.size &&
+                mtimeSec == other.mtimeSec && mtimeNsec == other.mtimeNsec &&
+                ctimeSec == other.ctimeSec && ctimeNsec == other.ctimeNsec;
+        }
+    };
+    // filled once by whichever caller gets there first, the others wait on this package only
+    struct CacheSlot {
+        std::once_flag once;
+        std::shared_ptr<const ModulePackInfoMeta> meta;
+    };
+    struct CacheEntry {
+        FileStamp stamp;
+        std::shared_ptr<CacheSlot> slot;
+    };
+    ModulePackInfoCache() = default;
+    ~ModulePackInfoCache() = default;
+    ModulePackInfoCache(const ModulePackInfoCache &) = delete;
+    ModulePackInfoCache &operator=(const ModulePackInfoCache &) = delete;
+    static bool GetFileStamp(const std::string &path, FileStamp &stamp);
+    static std::shared_ptr<const ModulePackInfoMeta> Load(const std::string &zipPath);
+
+    // guards the map only, packages are parsed outside of it
+    std::mutex mutex_;
+    std::unordered_map<std::string, CacheEntry> cache_ {};
+};
+} // namespace SysInstaller
+} // namespace OHOS
+#endif // SYS_INSTALLER_MODULE_PACK_INFO_CACHE_H
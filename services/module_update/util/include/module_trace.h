@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef SYS_INSTALLER_MODULE_TRACE_H
+#define SYS_INSTALLER_MODULE_TRACE_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace OHOS {
+namespace SysInstaller {
+static constexpr const char *TRACE_SPAN_ACTIVATE = "activate";
+static constexpr const char *TRACE_SPAN_REPOSITORY_SCAN = "repository scan";
+static constexpr const char *TRACE_SPAN_SIGN_VERIFY = "signature verify";
+static constexpr const char *TRACE_SPAN_PACK_INFO_PARSE = "pack.info parse";
+static constexpr const char *TRACE_SPAN_HVB_VERIFY = "hvb verify";
+static constexpr const char *TRACE_SPAN_LOOP_CREATE = "loop create";
+static constexpr const char *TRACE_SPAN_DM_CREATE = "dm create";
+static constexpr const char *TRACE_SPAN_DEVICE_WAIT = "device wait";
+static constexpr const char *TRACE_SPAN_MOUNT = "mount";
+
+// one complete span, times are microseconds on the monotonic clock
+struct ModuleTraceEvent {
+    std::string name;
+    std::string hmpName;
+    int64_t startUs = 0;
+    int64_t durUs = 0;
+    int32_t tid = 0;
+
+    int64_t EndUs() const
+    {
+        return startUs + durUs;
+    }
+};
+
+// collects activation phase spans and writes them as chrome trace json (loadable by perfetto)
+class ModuleTrace {
+public:
+    static ModuleTrace &GetInstance();
+    void Enable();
+    void Disable();
+    bool IsEnabled() const
+    {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+    void Record(ModuleTraceEvent &&event);
+    std::vector<ModuleTraceEvent> GetEvents();
+    void Clear();
+    bool Export(const std::string &path);
+
+private:
+    ModuleTrace() = default;
+    ~ModuleTrace() = default;
+    ModuleTrace(const ModuleTrace &) = delete;
+    ModuleTrace &operator=(const ModuleTrace &) = delete;
+
+    std::atomic<bool> enabled_ {false};
+    std::mutex mutex_;
+    std::vector<ModuleTraceEvent> events_ {};
+};
+
+// records [construction, destruction) as one span, costs a single atomic load when tracing is off
+class ModuleTraceSpan {
+public:
+    ModuleTraceSpan(const char *name, const std::string &hmpName);
+    ~ModuleTraceSpan();
+    ModuleTraceSpan(const ModuleTraceSpan &) = delete;
+    ModuleTraceSpan &operator=(const ModuleTraceSpan &) = delete;
+
+private:
+    const char *name_;
+    std::string hmpName_;
+    int64_t startUs_ = -1;
+};
+
+int64_t GetTraceTimeUs();
+bool LoadModuleTrace(const std::string &path, std::vector<ModuleTraceEvent> &events);
+// the hmp whose activation finished last, followed by its phases in start order
+std::vector<ModuleTraceEvent> GetTraceCriticalPath(const std::vector<ModuleTraceEvent> &events);
+} // namespace SysInstaller
+} // namespace OHOS
+#endif // SYS_INSTALLER_MODULE_TRACE_H
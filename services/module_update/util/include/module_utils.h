@@ -16,6 +16,7 @@
 #ifndef SYS_INSTALLER_MODULE_UTILS_H
 #define SYS_INSTALLER_MODULE_UTILS_H
 
+#include <functional>
 #include <sstream>
 #include <string>
 #include <sys/stat.h>
@@ -31,6 +32,8 @@ bool CheckPathExists(const std::string &path);
 bool CheckFileSuffix(const std::string &file, const std::string &suffix);
 std::string GetFileName(const std::string &file);
 std::string GetHmpName(const std::string &filePath);
+// woken by inotify on the parent dirs as soon as a file shows up, polls only when a parent is missing too
+bool WaitForFiles(const std::vector<std::string> &files, const std::chrono::nanoseconds &timeout);
 bool WaitForFile(const std::string &fpInfo, const std::chrono::nanoseconds &timeout);
 bool StartsWith(const std::string &str, const std::string &prefix);
 bool ReadFullyAtOffset(int fd, uint8_t *data, size_t count, off_t offset);
@@ -46,6 +49,10 @@ bool RemoveSpecifiedDir(const std::string &fpInfo, bool keepDir);
 std::string GetDeviceSaSdkVersion(void);
 int GetDeviceApiVersion(void);
 std::string GetContentFromZip(const std::string &zipPath, const std::string &fpInfo);
+bool ExtractZipEntryToFile(ModuleZipHelper &helper, const std::string &entryName, const std::string &outFile);
+// called with each extracted file path from the extracting worker, returning false aborts the extraction
+using ExtractedCallback = std::function<bool(const std::string &file)>;
+bool ExtractPackageToDir(const std::string &pkgPath, const std::string &outPath, const ExtractedCallback &onExtracted);
 bool CheckAndUpdateRevertResult(const std::string &hmpPath, const std::string &resultInfo, const std::string &keyWord);
 std::string GetCurrentHmpName(void);
 int32_t NotifyBmsRevert(const std::string &hmpName, bool record);
@@ -56,10 +63,13 @@ extern "C" {
 bool RevertImageCert(const std::string &hmpName, bool revertMore);
 bool VerityInfoWrite(const ModuleFile &file);
 bool PrepareFileToDestDir(const std::string &pkgPath, const std::string &outPath);
+bool DefaultPrepareFileToDestDir(const std::string &pkgPath, const std::string &outPath);
 void SetModuleVersion(const ModuleFile &file);
 #ifdef __cplusplus
 }
 #endif
+// true unless a strong PrepareFileToDestDir was linked in, only then ExtractPackageToDir may be used in its place
+bool IsDefaultPrepareFileToDestDir();
 
 class Timer {
 public:
@@ -12,39 +12,71 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
-
 #ifndef SYS_INSTALLER_MODULE_ZIP_HELPER_H
 #define SYS_INSTALLER_MODULE_ZIP_HELPER_H
 
 #include <cstdint>
+#include <functional>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
+#include "unique_fd.h"
 #include "unzip.h"
 #include "zip.h"
 
 namespace OHOS {
 namespace SysInstaller {
+struct ModuleZipEntry {
+    uint32_t index = 0; // position in central directory
+    uint32_t centralDirOffset = 0;
+    uint32_t localHeaderOffset = 0;
+    uint32_t compressedSize = 0;
+    uint32_t uncompressedSize = 0;
+    uint32_t crc = 0;
+    uint16_t method = 0;
+    uint32_t dataOffset = 0; // resolved from local header on first query, 0 means unresolved
+};
+
+constexpr size_t ZIP_CHUNK_WINDOW_SIZE = 256 * 1024;
+
 class ModuleZipHelper {
 public:
+    using ChunkConsumer = std::function<bool(const uint8_t *data, size_t size)>;
+
     explicit ModuleZipHelper(const std::string &path);
     ~ModuleZipHelper();
 
     bool IsValid() const
     {
-        return handle_ != nullptr;
+        return handle_ != nullptr && fd_.Get() != -1;
     }
     bool GetNumberOfEntry(uint32_t &number);
     bool LocateFile(const std::string &fpInfo);
     bool GetFileSize(uint32_t &size);
     bool GetFileOffset(uint32_t &offset);
     bool GetFileContent(std::string &buf);
+    // reads or inflates the located entry into a caller buffer of at least its uncompressed size
+    bool ReadFileContent(uint8_t *buffer, size_t size);
+    // hands the located entry to consumer in pieces of at most windowSize, memory stays bounded by the window
+    bool ReadFileChunks(const ChunkConsumer &consumer, size_t windowSize = ZIP_CHUNK_WINDOW_SIZE);
+    const ModuleZipEntry *FindEntry(const std::string &fpInfo) const;
+    void GetEntryNames(std::vector<std::string> &names) const;
 private:
-    bool GetFileEntryOffset(uint32_t &offset, uint32_t centralDirOffset) const;
+    bool BuildIndex();
+    bool IsStored(const ModuleZipEntry &entry) const;
+    bool InflateFileContent(uint8_t *buffer, uint32_t length);
+    bool InflateFileChunks(const ChunkConsumer &consumer, std::vector<uint8_t> &window);
+    bool ParseCentralDir(const std::vector<uint8_t> &centralDir, uint32_t centralDirOffset, uint32_t entryNum);
+    bool GetFileEntryOffset(ModuleZipEntry &entry) const;
     unzFile handle_ = nullptr;
-    bool hasLocated_ = false;
+    UniqueFd fd_;
+    uint32_t entryNum_ = 0;
+    std::unordered_map<std::string, ModuleZipEntry> entries_ {};
+    ModuleZipEntry *located_ = nullptr;
     std::string filename_;
     std::string zipPath_;
 };
 } // namespace SysInstaller
 } // namespace OHOS
-#endif // SYS_INSTALLER_MODULE_ZIP_HELPER_H
\ No newline at end of file
+#endif // SYS_INSTALLER_MODULE_ZIP_HELPER_H
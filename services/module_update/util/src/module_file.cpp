@@ -15,17 +15,20 @@
 
 #include "module_file.h"
 
+#include <charconv>
 #include <dlfcn.h>
 #include <fcntl.h>
 #include <sys/stat.h>
 #include <unistd.h>
 #include <unordered_set>
+#include <utility>
 
 #include "directory_ex.h"
 #include "module_utils.h"
 #include "json_node.h"
 #include "log/log.h"
 #include "module_constants.h"
+#include "module_pack_info_cache.h"
 #include "module_zip_helper.h"
 #include "package/package.h"
 #include "scope_guard.h"
@@ -242,43 +245,6 @@ bool ParseTrainInfo(const JsonNode &package, ModulePackageInfo &versionInfo)
     return true;
 }
 
-bool ParseModuleInfo(const string &packInfo, ModulePackageInfo &versionInfo)
-{
-    JsonNode root(packInfo);
-    const JsonNode &type = root["type"];
-    std::optional<string> hmpType = type.As<string>();
-    if (!hmpType.has_value()) {
-        LOG(ERROR) << "HmpInfo: Failed to get type val";
-        return false;
-    }
-    versionInfo.type = hmpType.value();
-
-    const JsonNode &package = root["package"];
-    if (!ParseHmpVersionInfo(package, versionInfo)) {
-        return false;
-    }
-
-    if (versionInfo.type == HMP_TRAIN_TYPE) {
-        return ParseTrainInfo(package, versionInfo);
-    }
-    ModuleInfo infoTmp;
-    // parse sa info
-    if (versionInfo.type == HMP_SA_TYPE || versionInfo.type == HMP_SA_TYPE_OLD ||
-        versionInfo.type == HMP_MIX_TYPE) {
-        if (!ParseSaList(package, infoTmp)) {
-            return false;
-        }
-    }
-    // parse bundle info
-    if (versionInfo.type == HMP_APP_TYPE || versionInfo.type == HMP_MIX_TYPE) {
-        if (!ParseBundleList(package, infoTmp)) {
-            return false;
-        }
-    }
-    versionInfo.moduleMap.emplace(versionInfo.hmpName, std::move(infoTmp));
-    return true;
-}
-
 // avp a= v>= p>=
 bool CompareSaVersion(const SaVersion &smaller, const SaVersion &bigger)
 {
@@ -351,6 +317,42 @@ bool ExtractZipFile(ModuleZipHelper &helper, const string &fpInfo, string &buf)
     return true;
 }
 
+bool ParseModuleInfo(const JsonNode &root, ModulePackageInfo &versionInfo)
+{
+    const JsonNode &type = root["type"];
+    std::optional<string> hmpType = type.As<string>();
+    if (!hmpType.has_value()) {
+        LOG(ERROR) << "HmpInfo: Failed to get type val";
+        return false;
+    }
+    versionInfo.type = hmpType.value();
+
+    const JsonNode &package = root["package"];
+    if (!ParseHmpVersionInfo(package, versionInfo)) {
+        return false;
+    }
+
+    if (versionInfo.type == HMP_TRAIN_TYPE) {
+        return ParseTrainInfo(package, versionInfo);
+    }
+    ModuleInfo infoTmp;
+    // parse sa info
+    if (versionInfo.type == HMP_SA_TYPE || versionInfo.type == HMP_SA_TYPE_OLD ||
+        versionInfo.type == HMP_MIX_TYPE) {
+        if (!ParseSaList(package, infoTmp)) {
+            return false;
+        }
+    }
+    // parse bundle info
+    if (versionInfo.type == HMP_APP_TYPE || versionInfo.type == HMP_MIX_TYPE) {
+        if (!ParseBundleList(package, infoTmp)) {
+            return false;
+        }
+    }
+    versionInfo.moduleMap.emplace(versionInfo.hmpName, std::move(infoTmp));
+    return true;
+}
+
 // MSFB M= S= F= B>
 bool CompareHmpVersion(const std::vector<string> &smallVersion, const std::vector<string> &bigVersion)
 {
@@ -435,6 +437,70 @@ bool ParseVersion(const string &version, const string &split, std::vector<string
     return true;
 }
 
+bool ParseHmpVersion(std::string_view version, char split, HmpVersion &hmpVersion)
+{
+    hmpVersion = HmpVersion {};
+    size_t index = version.rfind(split);
+    if (index == std::string_view::npos) {
+        return false;
+    }
+    // xxx-d01_4.10.0.1
+    const char *pos = version.data() + index + 1;
+    const char *end = version.data() + version.size();
+    for (size_t i = 0; i < HMP_VERSION_NUMBER_SIZE; i++) {
+        if (i != 0) {
+            if (pos == end || *pos != '.') {
+                return false;
+            }
+            pos++;
+        }
+        auto [ptr, ec] = std::from_chars(pos, end, hmpVersion.number[i]);
+        if (ec != std::errc() || ptr == pos) {
+            return false;
+        }
+        pos = ptr;
+    }
+    if (pos != end) {
+        return false;
+    }
+    hmpVersion.prefix = version.substr(0, index);
+    hmpVersion.valid = true;
+    return true;
+}
+
+// MSFB M= S= F= B>
+bool CompareHmpVersion(const HmpVersion &smallVersion, const HmpVersion &bigVersion)
+{
+    if (!smallVersion.valid || !bigVersion.valid) {
+        LOG(ERROR) << "invalid smallVersion " << smallVersion.valid << " invalid bigVersion " << bigVersion.valid;
+        return false;
+    }
+    if (!smallVersion.IsSamePrefix(bigVersion)) {
+        LOG(ERROR) << "pre version prefix not same as pkg";
+        return false;
+    }
+    return smallVersion.number[0] == bigVersion.number[0] && // 0: index of M
+        smallVersion.number[1] == bigVersion.number[1] && // 1: index of S
+        smallVersion.number[2] == bigVersion.number[2] && // 2: index of F
+        smallVersion.number[3] < bigVersion.number[3]; // 3: index of B
+}
+
+// MSFB M= S= F<=
+bool CompareSaSdkVersion(const HmpVersion &smallVersion, const HmpVersion &bigVersion)
+{
+    if (!smallVersion.valid || !bigVersion.valid) {
+        LOG(ERROR) << "invalid smallSaSdk " << smallVersion.valid << " ;invalid bigSaSdk " << bigVersion.valid;
+        return false;
+    }
+    if (!smallVersion.IsSamePrefix(bigVersion)) {
+        LOG(ERROR) << "pre saSdk prefix not same as pkg";
+        return false;
+    }
+    return smallVersion.number[0] == bigVersion.number[0] && // 0: index of M
+        smallVersion.number[1] == bigVersion.number[1] && // 1: index of S
+        smallVersion.number[2] >= bigVersion.number[2]; // 2: index of F
+}
+
 __attribute__((weak)) int32_t VerifyModulePackageSign(const std::string &fpInfo)
 {
     LOG(INFO) << "VerifyModulePackageSign " << fpInfo;
@@ -446,24 +512,63 @@ ModuleFile::~ModuleFile()
     ClearVerifiedData();
 }
 
-std::unique_ptr<ModuleFile> ModuleFile::Open(const string &fpInfo)
+ModuleFile::ModuleFile(const ModuleFile &other)
+    : modulePath_(other.modulePath_),
+      versionInfo_(other.versionInfo_),
+      hmpVersion_(other.hmpVersion_),
+      imageStat_(other.imageStat_) {}
+
+ModuleFile &ModuleFile::operator=(const ModuleFile &other)
 {
-    ModuleZipHelper helper(fpInfo);
-    if (!helper.IsValid()) {
-        LOG(ERROR) << "Failed to open file " << fpInfo;
-        return nullptr;
+    if (this != &other) {
+        ClearVerifiedData();
+        modulePath_ = other.modulePath_;
+        versionInfo_ = other.versionInfo_;
+        hmpVersion_ = other.hmpVersion_;
+        imageStat_ = other.imageStat_;
     }
+    return *this;
+}
 
-    string moduleInfo;
-    if (!ExtractZipFile(helper, PACK_INFO_NAME, moduleInfo)) {
-        LOG(ERROR) << "Failed to extract " << PACK_INFO_NAME << " from package " << fpInfo;
+ModuleFile::ModuleFile(ModuleFile &&other) noexcept
+    : modulePath_(std::move(other.modulePath_)),
+      versionInfo_(std::move(other.versionInfo_)),
+      hmpVersion_(other.hmpVersion_),
+      imageStat_(std::move(other.imageStat_))
+{
+#ifdef SUPPORT_HVB
+    vd_ = std::exchange(other.vd_, nullptr);
+#endif
+}
+
+ModuleFile &ModuleFile::operator=(ModuleFile &&other) noexcept
+{
+    if (this != &other) {
+        ClearVerifiedData();
+        modulePath_ = std::move(other.modulePath_);
+        versionInfo_ = std::move(other.versionInfo_);
+        hmpVersion_ = other.hmpVersion_;
+        imageStat_ = std::move(other.imageStat_);
+#ifdef SUPPORT_HVB
+        vd_ = std::exchange(other.vd_, nullptr);
+#endif
+    }
+    return *this;
+}
+
+std::unique_ptr<ModuleFile> ModuleFile::Open(const string &fpInfo)
+{
+    std::shared_ptr<const ModulePackInfoMeta> meta = ModulePackInfoCache::GetInstance().Get(fpInfo);
+    if (meta == nullptr) {
+        LOG(ERROR) << "Failed to load " << PACK_INFO_NAME << " from package " << fpInfo;
         return nullptr;
     }
-    ModulePackageInfo versionInfo;
-    if (!ParseModuleInfo(moduleInfo, versionInfo)) {
+    if (!meta->isModuleInfoValid) {
         LOG(ERROR) << "Failed to parse version info of package " << fpInfo;
         return nullptr;
     }
+    // shares the cached info instead of copying it into every module file
+    std::shared_ptr<const ModulePackageInfo> versionInfo(meta, &meta->moduleInfo);
 
     ImageStat tmpStat;
     std::optional<ImageStat> imageStat;
@@ -475,7 +580,7 @@ std::unique_ptr<ModuleFile> ModuleFile::Open(const string &fpInfo)
         return nullptr;
     }
 
-    return std::make_unique<ModuleFile>(fpInfo, versionInfo, imageStat);
+    return std::make_unique<ModuleFile>(fpInfo, std::move(versionInfo), imageStat);
 }
 
 bool ModuleFile::CompareVersion(const ModuleFile &newFile, const ModuleFile &oldFile)
@@ -483,16 +588,13 @@ bool ModuleFile::CompareVersion(const ModuleFile &newFile, const ModuleFile &old
     if (newFile.GetPath() == oldFile.GetPath()) {
         return true;
     }
-    std::vector<string> newVersion {};
-    std::vector<string> oldVersion {};
-    // version: xxx-d01 M.S.F.B
-    if (!ParseVersion(newFile.GetVersionInfo().version, " ", newVersion) ||
-        !ParseVersion(oldFile.GetVersionInfo().version, " ", oldVersion)) {
+    // parsed when the files were opened
+    if (!newFile.GetHmpVersion().valid || !oldFile.GetHmpVersion().valid) {
         LOG(ERROR) << "when compare version, parse version failed.";
         return false;
     }
 
-    if (!CompareHmpVersion(oldVersion, newVersion)) {
+    if (!CompareHmpVersion(oldFile.GetHmpVersion(), newFile.GetHmpVersion())) {
         LOG(ERROR) << "old hmp version: " << oldFile.GetVersionInfo().version <<
             "is higher than " << newFile.GetVersionInfo().version;
         return false;
@@ -503,15 +605,16 @@ bool ModuleFile::CompareVersion(const ModuleFile &newFile, const ModuleFile &old
         return false;
     }
     for (const auto& [key, value] : oldFile.GetVersionInfo().moduleMap) {
-        if (newFile.GetVersionInfo().moduleMap.find(key) == newFile.GetVersionInfo().moduleMap.end()) {
+        auto newIter = newFile.GetVersionInfo().moduleMap.find(key);
+        if (newIter == newFile.GetVersionInfo().moduleMap.end()) {
             LOG(ERROR) << key << " is not exist in new hmp.";
             return false;
         }
-        if (!CompareSaListVersion(value.saInfoList, newFile.GetVersionInfo().moduleMap.at(key).saInfoList)) {
+        if (!CompareSaListVersion(value.saInfoList, newIter->second.saInfoList)) {
             LOG(ERROR) << "old hmp sa version is higher.";
             return false;
         }
-        if (!CompareBundleList(value.bundleInfoList, newFile.GetVersionInfo().moduleMap.at(key).bundleInfoList)) {
+        if (!CompareBundleList(value.bundleInfoList, newIter->second.bundleInfoList)) {
             LOG(ERROR) << "new hmp bundle list do not meet expectation.";
             return false;
         }
@@ -551,7 +654,10 @@ bool ModuleFile::VerifyModuleVerity()
         ClearVerifiedData();
     };
     string imagePath = ExtractFilePath(GetPath()) + IMG_FILE_NAME;
-    enum hvb_errno ret = footer_init_desc(ModuleHvbGetOps(), imagePath.c_str(), nullptr, &pubkey, vd_);
+    // one context per verification, the image is resolved and opened once for all reads
+    ModuleHvbContext context;
+    ModuleHvbInitContext(context);
+    enum hvb_errno ret = footer_init_desc(&context.ops, imagePath.c_str(), nullptr, &pubkey, vd_);
     if (ret != HVB_OK) {
         LOG(ERROR) << "hvb verify failed err=" << ret;
         return false;
@@ -34,8 +34,7 @@ extern "C" {
 using namespace OHOS::SysInstaller;
 using namespace Updater;
 
-static bool ParseReadParam(const std::string &path, const int64_t offset, const uint64_t numBytes, off_t &outOffset,
-    size_t &outCount)
+static bool ResolveImage(const std::string &path, int64_t &imageOffset, int64_t &imageSize)
 {
     std::string modulePath = OHOS::ExtractFilePath(path) + HMP_INFO_NAME;
     std::unique_ptr<ModuleFile> file = ModuleFile::Open(modulePath);
@@ -47,8 +46,35 @@ static bool ParseReadParam(const std::string &path, const int64_t offset, const
         LOG(ERROR) << modulePath << " has no image";
         return false;
     }
-    int64_t imageOffset = static_cast<int64_t>(file->GetImageStat().value().imageOffset);
-    int64_t imageSize = static_cast<int64_t>(file->GetImageStat().value().imageSize);
+    imageOffset = static_cast<int64_t>(file->GetImageStat().value().imageOffset);
+    imageSize = static_cast<int64_t>(file->GetImageStat().value().imageSize);
+    return true;
+}
+
+static bool OpenImage(ModuleHvbContext &context, const std::string &fpInfo)
+{
+    std::string realPath = GetRealPath(fpInfo);
+    if (realPath.empty()) {
+        LOG(ERROR) << "invalid path " << fpInfo;
+        return false;
+    }
+    if (!ResolveImage(fpInfo, context.imageOffset, context.imageSize)) {
+        return false;
+    }
+    context.fd = OHOS::UniqueFd(open(realPath.c_str(), O_RDONLY | O_CLOEXEC));
+    if (context.fd.Get() == -1) {
+        LOG(ERROR) << "failed to open file " << realPath << " err=" << errno;
+        return false;
+    }
+    context.partition = fpInfo;
+    return true;
+}
+
+static bool ParseReadParam(const ModuleHvbContext &context, const int64_t offset, const uint64_t numBytes,
+    off_t &outOffset, size_t &outCount)
+{
+    int64_t imageOffset = context.imageOffset;
+    int64_t imageSize = context.imageSize;
     outOffset = offset + imageOffset;
     if (offset < 0) {
         outOffset += imageSize;
@@ -64,6 +90,15 @@ static bool ParseReadParam(const std::string &path, const int64_t offset, const
     return true;
 }
 
+static ModuleHvbContext *GetHvbContext(struct hvb_ops *ops)
+{
+    // the shared ops from ModuleHvbGetOps carry no context
+    if (ops == nullptr || ops == ModuleHvbGetOps() || ops->user_data == nullptr) {
+        return nullptr;
+    }
+    return static_cast<ModuleHvbContext *>(ops->user_data);
+}
+
 static enum hvb_io_errno HvbReadFromPartition(
     struct hvb_ops *ops, const char *partition, int64_t offset, uint64_t numBytes, void *buf, uint64_t *outNumRead)
 {
@@ -77,24 +112,22 @@ static enum hvb_io_errno HvbReadFromPartition(
     }
 
     std::string fpInfo = std::string(partition);
-    std::string realPath = GetRealPath(fpInfo);
-    if (realPath.empty()) {
-        LOG(ERROR) << "invalid path " << fpInfo;
+    // without a context every read resolves and opens the image again
+    ModuleHvbContext localContext;
+    ModuleHvbContext *context = GetHvbContext(ops);
+    if (context == nullptr) {
+        context = &localContext;
+    }
+    if ((context->fd.Get() == -1 || context->partition != fpInfo) && !OpenImage(*context, fpInfo)) {
         return HVB_IO_ERROR_IO;
     }
     off_t realOffset = 0;
     size_t count = 0;
-    if (!ParseReadParam(fpInfo, offset, numBytes, realOffset, count)) {
+    if (!ParseReadParam(*context, offset, numBytes, realOffset, count)) {
         return HVB_IO_ERROR_IO;
     }
-
-    OHOS::UniqueFd fd(open(realPath.c_str(), O_RDONLY | O_CLOEXEC));
-    if (fd.Get() == -1) {
-        LOG(ERROR) << "failed to open file " << realPath << " err=" << errno;
-        return HVB_IO_ERROR_IO;
-    }
-    if (!ReadFullyAtOffset(fd.Get(), reinterpret_cast<uint8_t *>(buf), count, realOffset)) {
-        LOG(ERROR) << "failed to read file " << realPath;
+    if (!ReadFullyAtOffset(context->fd.Get(), reinterpret_cast<uint8_t *>(buf), count, realOffset)) {
+        LOG(ERROR) << "failed to read file " << context->partition;
         return HVB_IO_ERROR_IO;
     }
     if (outNumRead != nullptr) {
@@ -179,4 +212,16 @@ struct hvb_ops *ModuleHvbGetOps(void)
 #if __cplusplus
 }
 #endif
-#endif
\ No newline at end of file
+#endif
+
+namespace OHOS {
+namespace SysInstaller {
+void ModuleHvbInitContext(ModuleHvbContext &context)
+{
+    context.ops = *ModuleHvbGetOps();
+    context.ops.user_data = &context;
+    context.partition.clear();
+    context.fd = UniqueFd(-1);
+}
+} // namespace SysInstaller
+} // namespace OHOS
@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "module_manifest.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/statvfs.h>
+
+#include "directory_ex.h"
+#include "log/log.h"
+#include "module_constants.h"
+#include "module_utils.h"
+#include "unique_fd.h"
+
+namespace OHOS {
+namespace SysInstaller {
+using namespace Updater;
+
+namespace {
+constexpr uint32_t FNV_OFFSET_BASIS = 2166136261U;
+constexpr uint32_t FNV_PRIME = 16777619U;
+constexpr uint32_t MANIFEST_ALIGN = 4;
+constexpr size_t MAX_MANIFEST_SIZE = 1024 * 1024;
+static_assert(sizeof(ModuleManifestHeader) % MANIFEST_ALIGN == 0, "manifest header must stay aligned");
+static_assert(sizeof(ModuleManifestModule) % MANIFEST_ALIGN == 0, "manifest module must stay aligned");
+static_assert(sizeof(ModuleManifestSa) % MANIFEST_ALIGN == 0, "manifest sa must stay aligned");
+static_assert(sizeof(ModuleManifestBundle) % MANIFEST_ALIGN == 0, "manifest bundle must stay aligned");
+
+uint32_t Fnv1a(const uint8_t *data, size_t size)
+{
+    uint32_t hash = FNV_OFFSET_BASIS;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= data[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+class ManifestReader {
+public:
+    ManifestReader(const char *strings, uint32_t size) : strings_(strings), size_(size) {}
+
+    bool GetString(const ModuleManifestStr &ref, std::optional<std::string> &str) const
+    {
+        if (ref.offset == MODULE_MANIFEST_NO_STR) {
+            str.reset();
+            return true;
+        }
+        if (static_cast<uint64_t>(ref.offset) + ref.size > size_) {
+            LOG(ERROR) << "manifest string out of range " << ref.offset << " " << ref.size;
+            return false;
+        }
+        str.emplace(strings_ + ref.offset, ref.size);
+        return true;
+    }
+
+    bool GetString(const ModuleManifestStr &ref, std::string &str) const
+    {
+        std::optional<std::string> tmp;
+        if (!GetString(ref, tmp)) {
+            return false;
+        }
+        str = tmp.value_or("");
+        return true;
+    }
+
+private:
+    const char *strings_;
+    uint32_t size_;
+};
+
+bool CheckHeader(const ModuleManifestHeader &header, size_t fileSize, const ModuleZipEntry &packInfo)
+{
+    if (header.magic != MODULE_MANIFEST_MAGIC || header.version != MODULE_MANIFEST_VERSION ||
+        header.headerSize != sizeof(ModuleManifestHeader) || header.fileSize != fileSize) {
+        LOG(WARNING) << "manifest header mismatch, version " << header.version;
+        return false;
+    }
+    if (header.packInfoCrc != packInfo.crc || header.packInfoSize != packInfo.uncompressedSize) {
+        LOG(INFO) << "manifest is stale, pack.info changed";
+        return false;
+    }
+    uint64_t bodySize = static_cast<uint64_t>(header.moduleNum) * sizeof(ModuleManifestModule) +
+        static_cast<uint64_t>(header.saNum) * sizeof(ModuleManifestSa) +
+        static_cast<uint64_t>(header.bundleNum) * sizeof(ModuleManifestBundle) + header.stringsSize;
+    if (sizeof(ModuleManifestHeader) + bodySize > fileSize) {
+        LOG(ERROR) << "manifest body out of range";
+        return false;
+    }
+    return true;
+}
+
+bool ParseManifestModules(const ModuleManifestHeader &header, const uint8_t *body, const ManifestReader &reader,
+    ModulePackageInfo &info)
+{
+    auto modules = reinterpret_cast<const ModuleManifestModule *>(body);
+    auto sas = reinterpret_cast<const ModuleManifestSa *>(modules + header.moduleNum);
+    auto bundles = reinterpret_cast<const ModuleManifestBundle *>(sas + header.saNum);
+    info.moduleMap.reserve(header.moduleNum);
+    for (uint32_t i = 0; i < header.moduleNum; i++) {
+        const ModuleManifestModule &module = modules[i];
+        if (static_cast<uint64_t>(module.saBegin) + module.saNum > header.saNum ||
+            static_cast<uint64_t>(module.bundleBegin) + module.bundleNum > header.bundleNum) {
+            LOG(ERROR) << "manifest module " << i << " out of range";
+            return false;
+        }
+        std::string name;
+        if (!reader.GetString(module.name, name)) {
+            return false;
+        }
+        ModuleInfo moduleInfo;
+        for (uint32_t j = module.saBegin; j < module.saBegin + module.saNum; j++) {
+            SaInfo &sa = moduleInfo.saInfoList.emplace_back();
+            if (!reader.GetString(sas[j].name, sa.saName)) {
+                return false;
+            }
+            sa.saId = sas[j].saId;
+            sa.version = {sas[j].apiVersion, sas[j].versionCode, sas[j].patchVersion};
+        }
+        for (uint32_t j = module.bundleBegin; j < module.bundleBegin + module.bundleNum; j++) {
+            BundleInfo &bundle = moduleInfo.bundleInfoList.emplace_back();
+            if (!reader.GetString(bundles[j].name, bundle.bundleName) ||
+                !reader.GetString(bundles[j].version, bundle.bundleVersion)) {
+                return false;
+            }
+        }
+        info.moduleMap.emplace(std::move(name), std::move(moduleInfo));
+    }
+    return true;
+}
+
+bool ParseManifest(const uint8_t *data, size_t size, const ModuleZipEntry &packInfo, ModulePackInfoMeta &meta)
+{
+    if (size < sizeof(ModuleManifestHeader)) {
+        LOG(ERROR) << "manifest too small " << size;
+        return false;
+    }
+    const ModuleManifestHeader &header = *reinterpret_cast<const ModuleManifestHeader *>(data);
+    if (!CheckHeader(header, size, packInfo)) {
+        return false;
+    }
+    const uint8_t *body = data + sizeof(ModuleManifestHeader);
+    if (Fnv1a(body, size - sizeof(ModuleManifestHeader)) != header.checksum) {
+        LOG(ERROR) << "manifest checksum mismatch";
+        return false;
+    }
+    size_t recordSize = header.moduleNum * sizeof(ModuleManifestModule) + header.saNum * sizeof(ModuleManifestSa) +
+        header.bundleNum * sizeof(ModuleManifestBundle);
+    ManifestReader reader(reinterpret_cast<const char *>(body + recordSize), header.stringsSize);
+    std::optional<std::string> *fields[MANIFEST_HMP_NAME] = {
+        &meta.type, &meta.packageType, &meta.imageHash, &meta.name, &meta.version, &meta.apiVersion,
+        &meta.saSdkVersion, &meta.compatibleVersion, &meta.laneCode,
+    };
+    for (uint32_t i = 0; i < MANIFEST_HMP_NAME; i++) {
+        if (!reader.GetString(header.fields[i], *fields[i])) {
+            return false;
+        }
+    }
+    ModulePackageInfo &info = meta.moduleInfo;
+    if (!reader.GetString(header.fields[MANIFEST_HMP_NAME], info.hmpName) ||
+        !reader.GetString(header.fields[MANIFEST_HMP_VERSION], info.version) ||
+        !reader.GetString(header.fields[MANIFEST_HMP_DISPLAY_VERSION], info.displayVersion) ||
+        !reader.GetString(header.fields[MANIFEST_HMP_SA_SDK_VERSION], info.saSdkVersion) ||
+        !reader.GetString(header.fields[MANIFEST_HMP_TYPE], info.type)) {
+        return false;
+    }
+    info.apiVersion = header.hmpApiVersion;
+    meta.isModuleInfoValid = header.isModuleInfoValid != 0;
+    return ParseManifestModules(header, body, reader, info);
+}
+
+bool LoadManifestFd(int fd, const std::string &manifestPath, const ModuleZipEntry &packInfo,
+    ModulePackInfoMeta &meta)
+{
+    struct stat st {};
+    if (fstat(fd, &st) != 0 || st.st_size <= 0 || static_cast<size_t>(st.st_size) > MAX_MANIFEST_SIZE) {
+        LOG(ERROR) << "invalid manifest " << manifestPath;
+        return false;
+    }
+    size_t size = static_cast<size_t>(st.st_size);
+    void *addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (addr == MAP_FAILED) {
+        LOG(ERROR) << "failed to map manifest " << manifestPath << " err=" << errno;
+        return false;
+    }
+    ModulePackInfoMeta tmpMeta;
+    bool ret = ParseManifest(static_cast<const uint8_t *>(addr), size, packInfo, tmpMeta);
+    munmap(addr, size);
+    if (ret) {
+        meta = std::move(tmpMeta);
+    }
+    return ret;
+}
+}
+
+bool LoadModuleManifest(const std::string &manifestPath, const ModuleZipEntry &packInfo, ModulePackInfoMeta &meta)
+{
+    UniqueFd fd(open(manifestPath.c_str(), O_RDONLY | O_CLOEXEC));
+    if (fd.Get() == -1) {
+        return false;
+    }
+    return LoadManifestFd(fd.Get(), manifestPath, packInfo, meta);
+}
+
+bool LoadTrustedModuleManifest(const std::string &zipPath, const ModuleZipEntry &packInfo, ModulePackInfoMeta &meta)
+{
+    if (!StartsWith(zipPath, std::string(MODULE_PREINSTALL_DIR) + "/")) {
+        return false;
+    }
+    std::string manifestPath = ExtractFilePath(zipPath) + PACK_INFO_BIN_NAME;
+    UniqueFd fd(open(manifestPath.c_str(), O_RDONLY | O_CLOEXEC));
+    if (fd.Get() == -1) {
+        return false;
+    }
+    // the crc only tells a stale manifest apart, a writable one could be forged to match
+    struct statvfs vfs {};
+    if (fstatvfs(fd.Get(), &vfs) != 0 || (vfs.f_flag & ST_RDONLY) == 0) {
+        LOG(WARNING) << "ignore manifest not on a read only partition " << manifestPath;
+        return false;
+    }
+    return LoadManifestFd(fd.Get(), manifestPath, packInfo, meta);
+}
+
+} // namespace SysInstaller
+} // namespace OHOS
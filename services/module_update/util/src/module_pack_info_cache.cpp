@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "module_pack_info_cache.h"
+
+#include <sys/stat.h>
+
+#include "directory_ex.h"
+#include "json_node.h"
+#include "log/log.h"
+#include "module_constants.h"
+#include "module_manifest.h"
+#include "module_trace.h"
+#include "module_utils.h"
+#include "module_zip_helper.h"
+
+namespace OHOS {
+namespace SysInstaller {
+using namespace Updater;
+
+namespace {
+constexpr size_t MAX_PACK_INFO_CACHE_NUM = 64;
+}
+
+ModulePackInfoCache &ModulePackInfoCache::GetInstance()
+{
+    static ModulePackInfoCache instance;
+    return instance;
+}
+
+bool ModulePackInfoCache::GetFileStamp(const std::string &path, FileStamp &stamp)
+{
+    struct stat st {};
+    if (stat(path.c_str(), &st) != 0) {
+        return false;
+    }
+    stamp.dev = st.st_dev;
+    stamp.ino = st.st_ino;
+    stamp.size = st.st_size;
+    stamp.mtimeSec = static_cast<int64_t>(st.st_mtim.tv_sec);
+    stamp.mtimeNsec = static_cast<int64_t>(st.st_mtim.tv_nsec);
+    stamp.ctimeSec = static_cast<int64_t>(st.st_ctim.tv_sec);
+    stamp.ctimeNsec = static_cast<int64_t>(st.st_ctim.tv_nsec);
+    return true;
+}
+
+std::shared_ptr<ModulePackInfoMeta> ParsePackInfoMeta(const std::string &packInfo)
+{
+    JsonNode root(packInfo);
+    auto meta = std::make_shared<ModulePackInfoMeta>();
+    meta->isModuleInfoValid = ParseModuleInfo(root, meta->moduleInfo);
+    meta->type = root["type"].As<std::string>();
+    meta->packageType = root["packageType"].As<std::string>();
+    meta->imageHash = root["imageHash"].As<std::string>();
+    const JsonNode &package = root["package"];
+    meta->name = package["name"].As<std::string>();
+    meta->version = package["version"].As<std::string>();
+    meta->apiVersion = package[HMP_API_VERSION].As<std::string>();
+    meta->saSdkVersion = package[HMP_SA_SDK_VERSION].As<std::string>();
+    const JsonNode &laneInfo = package["laneInfo"];
+    meta->compatibleVersion = laneInfo["compatibleVersion"].As<std::string>();
+    meta->laneCode = laneInfo["laneCode"].As<std::string>();
+    return meta;
+}
+
+std::shared_ptr<const ModulePackInfoMeta> ModulePackInfoCache::Load(const std::string &zipPath)
+{
+    ModuleTraceSpan span(TRACE_SPAN_PACK_INFO_PARSE, GetHmpName(zipPath));
+    ModuleZipHelper helper(zipPath);
+    if (!helper.IsValid()) {
+        LOG(ERROR) << "Failed to open file " << zipPath;
+        return nullptr;
+    }
+    const ModuleZipEntry *packInfoEntry = helper.FindEntry(PACK_INFO_NAME);
+    if (packInfoEntry == nullptr) {
+        LOG(ERROR) << "Failed to find " << PACK_INFO_NAME << " in package " << zipPath;
+        return nullptr;
+    }
+    // a precompiled manifest matching this pack.info saves the json parse
+    auto meta = std::make_shared<ModulePackInfoMeta>();
+    if (LoadTrustedModuleManifest(zipPath, *packInfoEntry, *meta)) {
+        return meta;
+    }
+    std::string packInfo;
+    if (!ExtractZipFile(helper, PACK_INFO_NAME, packInfo)) {
+        LOG(ERROR) << "Failed to extract " << PACK_INFO_NAME << " from package " << zipPath;
+        return nullptr;
+    }
+    return ParsePackInfoMeta(packInfo);
+}
+
+std::shared_ptr<const ModulePackInfoMeta> ModulePackInfoCache::Get(const std::string &zipPath)
+{
+    std::string realPath = GetRealPath(zipPath);
+    FileStamp stamp;
+    if (realPath.empty() || !GetFileStamp(realPath, stamp)) {
+        LOG(ERROR) << "Invalid path " << zipPath;
+        Invalidate(zipPath);
+        return nullptr;
+    }
+    std::shared_ptr<CacheSlot> slot;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto iter = cache_.find(realPath);
+        if (iter != cache_.end() && iter->second.stamp == stamp) {
+            slot = iter->second.slot;
+        } else {
+            if (iter != cache_.end()) {
+                LOG(INFO) << "Package changed, reload pack info of " << realPath;
+                cache_.erase(iter);
+            }
+            if (cache_.size() >= MAX_PACK_INFO_CACHE_NUM) {
+                cache_.clear();
+            }
+            slot = std::make_shared<CacheSlot>();
+            cache_.emplace(realPath, CacheEntry {stamp, slot});
+        }
+    }
+    // concurrent callers of the same package still unzip it only once, other packages are not held up
+    std::call_once(slot->once, [&slot, &realPath] { slot->meta = Load(realPath); });
+    if (slot->meta == nullptr) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto iter = cache_.find(realPath);
+        if (iter != cache_.end() && iter->second.slot == slot) {
+            cache_.erase(iter);
+        }
+    }
+    return slot->meta;
+}
+
+void ModulePackInfoCache::Invalidate(const std::string &zipPath)
+{
+    std::string realPath = GetRealPath(zipPath);
+    std::lock_guard<std::mutex> lock(mutex_);
+    cache_.erase(realPath.empty() ? zipPath : realPath);
+}
+
+void ModulePackInfoCache::Clear()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    cache_.clear();
+}
+} // namespace SysInstaller
+} // namespace OHOS
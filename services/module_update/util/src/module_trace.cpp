@@ -0,0 +1,247 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "module_trace.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <sstream>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "cJSON.h"
+#include "log/log.h"
+
+namespace OHOS {
+namespace SysInstaller {
+using namespace Updater;
+
+namespace {
+constexpr int64_t US_PER_SECOND = 1000000;
+constexpr int64_t NS_PER_US = 1000;
+constexpr size_t MAX_TRACE_EVENT_NUM = 4096;
+constexpr const char *TRACE_CATEGORY = "module_update";
+
+std::string EscapeJson(const std::string &str)
+{
+    std::string out;
+    out.reserve(str.size());
+    for (char c : str) {
+        if (c == '"' || c == '\\') {
+            out.push_back('\\');
+            out.push_back(c);
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            out.push_back(' ');
+        } else {
+            out.push_back(c);
+        }
+    }
+    return out;
+}
+
+bool GetJsonNumber(const cJSON *item, const char *key, int64_t &value)
+{
+    const cJSON *node = cJSON_GetObjectItemCaseSensitive(item, key);
+    if (!cJSON_IsNumber(node)) {
+        return false;
+    }
+    value = static_cast<int64_t>(node->valuedouble);
+    return true;
+}
+}
+
+int64_t GetTraceTimeUs()
+{
+    struct timespec ts {};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * US_PER_SECOND + static_cast<int64_t>(ts.tv_nsec) / NS_PER_US;
+}
+
+ModuleTrace &ModuleTrace::GetInstance()
+{
+    static ModuleTrace instance;
+    return instance;
+}
+
+void ModuleTrace::Enable()
+{
+    enabled_.store(true, std::memory_order_relaxed);
+}
+
+void ModuleTrace::Disable()
+{
+    enabled_.store(false, std::memory_order_relaxed);
+}
+
+void ModuleTrace::Record(ModuleTraceEvent &&event)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (events_.size() >= MAX_TRACE_EVENT_NUM) {
+        return;
+    }
+    events_.emplace_back(std::move(event));
+}
+
+std::vector<ModuleTraceEvent> ModuleTrace::GetEvents()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return events_;
+}
+
+void ModuleTrace::Clear()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    events_.clear();
+}
+
+bool ModuleTrace::Export(const std::string &path)
+{
+    std::vector<ModuleTraceEvent> events = GetEvents();
+    std::sort(events.begin(), events.end(), [](const ModuleTraceEvent &a, const ModuleTraceEvent &b) {
+        return a.startUs < b.startUs;
+    });
+    std::ostringstream out;
+    int32_t pid = static_cast<int32_t>(getpid());
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    for (size_t i = 0; i < events.size(); i++) {
+        const ModuleTraceEvent &event = events[i];
+        out << (i == 0 ? "\n" : ",\n") << "{\"name\":\"" << EscapeJson(event.name) << "\",\"cat\":\"" <<
+            TRACE_CATEGORY << "\",\"ph\":\"X\",\"ts\":" << event.startUs << ",\"dur\":" << event.durUs <<
+            ",\"pid\":" << pid << ",\"tid\":" << event.tid << ",\"args\":{\"hmp\":\"" <<
+            EscapeJson(event.hmpName) << "\"}}";
+    }
+    out << "\n]}\n";
+    // write aside and rename so a reader never sees a half written trace
+    std::string tmpPath = path + ".tmp";
+    std::ofstream file(tmpPath, std::ios::out | std::ios::trunc);
+    if (!file.is_open()) {
+        LOG(ERROR) << "Failed to open " << tmpPath;
+        return false;
+    }
+    file << out.str();
+    file.close();
+    if (file.fail() || rename(tmpPath.c_str(), path.c_str()) != 0) {
+        LOG(ERROR) << "Failed to write trace " << path;
+        (void)unlink(tmpPath.c_str());
+        return false;
+    }
+    LOG(INFO) << "Export " << events.size() << " trace events to " << path;
+    return true;
+}
+
+ModuleTraceSpan::ModuleTraceSpan(const char *name, const std::string &hmpName) : name_(name)
+{
+    if (!ModuleTrace::GetInstance().IsEnabled()) {
+        return;
+    }
+    hmpName_ = hmpName;
+    startUs_ = GetTraceTimeUs();
+}
+
+ModuleTraceSpan::~ModuleTraceSpan()
+{
+    if (startUs_ < 0) {
+        return;
+    }
+    // callers log errno right after the traced call
+    int savedErrno = errno;
+    ModuleTraceEvent event;
+    event.name = name_;
+    event.hmpName = std::move(hmpName_);
+    event.startUs = startUs_;
+    event.durUs = GetTraceTimeUs() - startUs_;
+    event.tid = static_cast<int32_t>(syscall(SYS_gettid));
+    ModuleTrace::GetInstance().Record(std::move(event));
+    errno = savedErrno;
+}
+
+bool LoadModuleTrace(const std::string &path, std::vector<ModuleTraceEvent> &events)
+{
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        LOG(ERROR) << "Failed to open " << path;
+        return false;
+    }
+    std::stringstream buf;
+    buf << file.rdbuf();
+    cJSON *root = cJSON_Parse(buf.str().c_str());
+    if (root == nullptr) {
+        LOG(ERROR) << "Failed to parse trace " << path;
+        return false;
+    }
+    const cJSON *traceEvents = cJSON_GetObjectItemCaseSensitive(root, "traceEvents");
+    if (!cJSON_IsArray(traceEvents)) {
+        LOG(ERROR) << "No traceEvents in " << path;
+        cJSON_Delete(root);
+        return false;
+    }
+    events.clear();
+    const cJSON *item = nullptr;
+    cJSON_ArrayForEach(item, traceEvents) {
+        const cJSON *name = cJSON_GetObjectItemCaseSensitive(item, "name");
+        if (!cJSON_IsString(name)) {
+            continue;
+        }
+        ModuleTraceEvent event;
+        event.name = name->valuestring;
+        int64_t tid = 0;
+        if (!GetJsonNumber(item, "ts", event.startUs) || !GetJsonNumber(item, "dur", event.durUs)) {
+            continue;
+        }
+        if (GetJsonNumber(item, "tid", tid)) {
+            event.tid = static_cast<int32_t>(tid);
+        }
+        const cJSON *args = cJSON_GetObjectItemCaseSensitive(item, "args");
+        const cJSON *hmp = cJSON_GetObjectItemCaseSensitive(args, "hmp");
+        if (cJSON_IsString(hmp)) {
+            event.hmpName = hmp->valuestring;
+        }
+        events.emplace_back(std::move(event));
+    }
+    cJSON_Delete(root);
+    return true;
+}
+
+std::vector<ModuleTraceEvent> GetTraceCriticalPath(const std::vector<ModuleTraceEvent> &events)
+{
+    const ModuleTraceEvent *last = nullptr;
+    for (const auto &event : events) {
+        if (event.name != TRACE_SPAN_ACTIVATE) {
+            continue;
+        }
+        if (last == nullptr || event.EndUs() > last->EndUs()) {
+            last = &event;
+        }
+    }
+    std::vector<ModuleTraceEvent> path;
+    if (last == nullptr) {
+        return path;
+    }
+    path.push_back(*last);
+    for (const auto &event : events) {
+        if (&event != last && event.hmpName == last->hmpName && event.startUs >= last->startUs &&
+            event.EndUs() <= last->EndUs()) {
+            path.push_back(event);
+        }
+    }
+    std::stable_sort(path.begin() + 1, path.end(), [](const ModuleTraceEvent &a, const ModuleTraceEvent &b) {
+        return a.startUs < b.startUs;
+    });
+    return path;
+}
+} // namespace SysInstaller
+} // namespace OHOS
@@ -19,13 +19,13 @@
 #include "diff_patch/diff_patch_interface.h" // update diff interface
 #include "hash_data_verifier.h"
 #include "log/log.h"
-#include "json_node.h"
 #include "openssl/sha.h"
 #include "parameters.h"
 #include "scope_guard.h"
 #include "utils.h"
 #include "module_constants.h"
 #include "module_file.h"
+#include "module_pack_info_cache.h"
 #include "module_utils.h"
 
 namespace OHOS {
@@ -34,18 +34,6 @@ using namespace Hpackage;
 using namespace Updater;
 
 namespace {
-bool GetHmpType(const JsonNode &root, std::string &type)
-{
-    const JsonNode &typeJson = root["type"];
-    std::optional<std::string> hmpType = typeJson.As<std::string>();
-    if (!hmpType.has_value()) {
-        LOG(ERROR) << "HmpInfo: Failed to get type val";
-        return false;
-    }
-    type = hmpType.value();
-    return true;
-}
-
 bool CheckApiVersion(const std::string &apiVersion)
 {
     if (apiVersion.empty()) {
@@ -68,28 +56,26 @@ bool CheckSaSdkVersion(const std::string &saSdkVersion)
         LOG(INFO) << "saSdkVersion is empty, default is true.";
         return true;
     }
-    std::vector<std::string> saSdkVersionVec {};
+    HmpVersion sysVersion {};
     std::string sysSaSdkVersion = GetDeviceSaSdkVersion();
-    if (!ParseVersion(sysSaSdkVersion, "_", saSdkVersionVec)) {
+    if (!ParseHmpVersion(sysSaSdkVersion, '_', sysVersion)) {
         LOG(ERROR) << "ParseVersion sysSaSdkVersion failed: " << sysSaSdkVersion;
         return false;
     }
-    std::vector<std::string> hmpVersionVec {};
-    if (!ParseVersion(saSdkVersion, "_", hmpVersionVec)) {
+    HmpVersion hmpVersion {};
+    if (!ParseHmpVersion(saSdkVersion, '_', hmpVersion)) {
         LOG(ERROR) << "ParseVersion hmpSaSdkVersion failed: " << saSdkVersion;
         return false;
     }
-    if (!CompareSaSdkVersion(saSdkVersionVec, hmpVersionVec)) {
+    if (!CompareSaSdkVersion(sysVersion, hmpVersion)) {
         LOG(ERROR) << "saSdkVersion compare fail, sys:" << sysSaSdkVersion << "; hmp:" << saSdkVersion;
         return false;
     }
     return true;
 }
 
-bool GetPackInfoVer(const JsonNode &root, const std::string &key, std::string &version)
+bool GetPackInfoVer(const std::optional<std::string> &tmpVersion, const std::string &key, std::string &version)
 {
-    const JsonNode &package = root["package"];
-    std::optional<std::string> tmpVersion = package[key].As<std::string>();
     if (!tmpVersion.has_value()) {
         LOG(ERROR) << "count get version val";
         return false;
@@ -98,41 +84,29 @@ bool GetPackInfoVer(const JsonNode &root, const std::string &key, std::string &v
     LOG(INFO) << key << " " << version;
     return true;
 }
-
-bool GetPackageType(const JsonNode &root, std::string &type)
-{
-    const JsonNode &typeJson = root["packageType"];
-    std::optional<std::string> hmpPackageType = typeJson.As<std::string>();
-    if (!hmpPackageType.has_value()) {
-        LOG(ERROR) << "HmpInfo: Failed to get type val";
-        return false;
-    }
-    type = hmpPackageType.value();
-    return true;
-}
 }
 
 bool CheckPackInfoVer(const std::string &pkgPackInfoPath)
 {
-    std::string packInfo = GetContentFromZip(pkgPackInfoPath, PACK_INFO_NAME);
-    JsonNode root(packInfo);
-    std::string type;
-    if (!GetHmpType(root, type)) {
+    std::shared_ptr<const ModulePackInfoMeta> meta = ModulePackInfoCache::GetInstance().Get(pkgPackInfoPath);
+    if (meta == nullptr || !meta->type.has_value()) {
+        LOG(ERROR) << "HmpInfo: Failed to get type val";
         return false;
     }
+    const std::string &type = meta->type.value();
     LOG(INFO) << pkgPackInfoPath << "; type = " << type;
     std::string apiVersion;
-    if (type == HMP_APP_TYPE && GetPackInfoVer(root, HMP_API_VERSION, apiVersion)) {
+    if (type == HMP_APP_TYPE && GetPackInfoVer(meta->apiVersion, HMP_API_VERSION, apiVersion)) {
         return CheckApiVersion(apiVersion);
     }
     std::string saSdkVersion;
     if ((type == HMP_SA_TYPE || type == HMP_SA_TYPE_OLD) &&
-        GetPackInfoVer(root, HMP_SA_SDK_VERSION, saSdkVersion)) {
+        GetPackInfoVer(meta->saSdkVersion, HMP_SA_SDK_VERSION, saSdkVersion)) {
         return CheckSaSdkVersion(saSdkVersion);
     }
     if ((type == HMP_MIX_TYPE || type == HMP_TRAIN_TYPE) &&
-        GetPackInfoVer(root, HMP_SA_SDK_VERSION, saSdkVersion) &&
-        GetPackInfoVer(root, HMP_API_VERSION, apiVersion)) {
+        GetPackInfoVer(meta->saSdkVersion, HMP_SA_SDK_VERSION, saSdkVersion) &&
+        GetPackInfoVer(meta->apiVersion, HMP_API_VERSION, apiVersion)) {
         return CheckApiVersion(apiVersion) && CheckSaSdkVersion(saSdkVersion);
     }
     return false;
@@ -149,13 +123,12 @@ void CleanErrDir(const std::string &fpInfo)
 
 bool IsIncrementPackage(const std::string &pkgPackInfoPath)
 {
-    std::string packInfo = GetContentFromZip(pkgPackInfoPath, PACK_INFO_NAME);
-    JsonNode root(packInfo);
-    std::string packageType;
-    if (!GetPackageType(root, packageType)) {
+    std::shared_ptr<const ModulePackInfoMeta> meta = ModulePackInfoCache::GetInstance().Get(pkgPackInfoPath);
+    if (meta == nullptr || !meta->packageType.has_value()) {
         LOG(INFO) << pkgPackInfoPath << " not support increment";
         return false;
     }
+    const std::string &packageType = meta->packageType.value();
     LOG(INFO) << pkgPackInfoPath << "; packageType = " << packageType;
     if (packageType == HMP_INCR_PACKAGE_TYPE) {
         return true;
@@ -165,15 +138,12 @@ bool IsIncrementPackage(const std::string &pkgPackInfoPath)
 
 bool ReadHashFromPackInfo(const std::string &pkgPackInfoPath, std::string &hashValue)
 {
-    std::string packInfo = GetContentFromZip(pkgPackInfoPath, PACK_INFO_NAME);
-    JsonNode root(packInfo);
-    const JsonNode &imageHashJson = root["imageHash"];
-    std::optional<std::string> imageHash = imageHashJson.As<std::string>();
-    if (!imageHash.has_value()) {
+    std::shared_ptr<const ModulePackInfoMeta> meta = ModulePackInfoCache::GetInstance().Get(pkgPackInfoPath);
+    if (meta == nullptr || !meta->imageHash.has_value()) {
         LOG(ERROR) << "HmpInfo: Failed to get imageHash val";
         return false;
     }
-    hashValue = imageHash.value();
+    hashValue = meta->imageHash.value();
     return true;
 }
 
@@ -14,9 +14,13 @@
  */
 
 #include "module_utils.h"
+#include <algorithm>
+#include <atomic>
 #include <cerrno>
 #include <cstdio>
 #include <dirent.h>
+#include <poll.h>
+#include <sys/inotify.h>
 #include <sys/mount.h>
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -36,6 +40,8 @@
 #include "utils.h"
 #include "module_constants.h"
 #include "module_file.h"
+#include "module_zip_helper.h"
+#include "unique_fd.h"
 
 namespace OHOS {
 namespace SysInstaller {
@@ -46,8 +52,12 @@ constexpr const char *BOOT_COMPLETE_PARAM = "bootevent.boot.completed";
 constexpr const char *BOOT_SUCCESS_VALUE = "true";
 constexpr int32_t PARAM_VALUE_SIZE = 10;
 constexpr std::chrono::milliseconds WAIT_FOR_FILE_TIME(5);
+constexpr size_t INOTIFY_BUF_SIZE = 4096;
 constexpr uint32_t BYTE_SIZE = 8;
 constexpr mode_t ALL_PERMISSIONS = 0777;
+constexpr mode_t EXTRACT_DIR_MODE = 0750;
+constexpr mode_t EXTRACT_FILE_MODE = 0644;
+constexpr size_t MAX_EXTRACT_THREAD_NUM = 4;
 constexpr const char *PREFIXES[] = {UPDATE_INSTALL_DIR, UPDATE_ACTIVE_DIR, UPDATE_BACKUP_DIR, MODULE_PREINSTALL_DIR};
 }
 
@@ -131,20 +141,81 @@ std::string GetHmpName(const std::string &filePath)
     return filePath.substr(startPos, endPos - startPos);
 }
 
+namespace {
+bool AnyFileExists(const std::vector<std::string> &files)
+{
+    struct stat buffer;
+    return std::any_of(files.begin(), files.end(),
+        [&buffer](const std::string &file) { return stat(file.c_str(), &buffer) == 0; });
+}
+
+// watches the parent dirs of files, the caller re-checks the files after every wake up
+UniqueFd WatchParentDirs(const std::vector<std::string> &files)
+{
+    UniqueFd fd(inotify_init1(IN_CLOEXEC | IN_NONBLOCK));
+    if (fd.Get() == -1) {
+        LOG(WARNING) << "inotify_init1 failed, err=" << errno;
+        return fd;
+    }
+    for (const auto &file : files) {
+        std::string dir = ExtractFilePath(file);
+        if (inotify_add_watch(fd.Get(), dir.c_str(), IN_CREATE | IN_MOVED_TO | IN_ATTRIB) == -1) {
+            // parent not there yet either, fall back to polling
+            return UniqueFd(-1);
+        }
+    }
+    return fd;
+}
+
+void DrainInotify(int fd)
+{
+    alignas(struct inotify_event) char buf[INOTIFY_BUF_SIZE];
+    while (read(fd, buf, sizeof(buf)) > 0) {}
+}
+}
+
+bool WaitForFiles(const std::vector<std::string> &files, const std::chrono::nanoseconds &timeout)
+{
+    if (AnyFileExists(files)) {
+        return true;
+    }
+    UniqueFd notifyFd = WatchParentDirs(files);
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    // a node created between the first check and the watch would never wake us
+    while (!AnyFileExists(files)) {
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now());
+        if (remaining.count() <= 0) {
+            return false;
+        }
+        if (notifyFd.Get() == -1) {
+            std::this_thread::sleep_for(std::min(remaining, WAIT_FOR_FILE_TIME));
+            continue;
+        }
+        struct pollfd pfd = {notifyFd.Get(), POLLIN, 0};
+        int ret = poll(&pfd, 1, static_cast<int>(remaining.count()));
+        if (ret < 0 && errno != EINTR) {
+            LOG(WARNING) << "poll inotify failed, err=" << errno;
+            notifyFd = UniqueFd(-1);
+            continue;
+        }
+        if (ret > 0) {
+            DrainInotify(notifyFd.Get());
+        }
+    }
+    return true;
+}
+
 bool WaitForFile(const std::string &fpInfo, const std::chrono::nanoseconds &timeout)
 {
+    // the common case, nothing to wait for and nothing to log
+    if (AnyFileExists({fpInfo})) {
+        return true;
+    }
     Timer timer;
-    bool hasSlept = false;
-    while (timer.duration() < timeout) {
-        struct stat buffer;
-        if (stat(fpInfo.c_str(), &buffer) != -1) {
-            if (hasSlept) {
-                LOG(INFO) << "wait for '" << fpInfo << "' took " << timer;
-            }
-            return true;
-        }
-        std::this_thread::sleep_for(WAIT_FOR_FILE_TIME);
-        hasSlept = true;
+    if (WaitForFiles({fpInfo}, timeout)) {
+        LOG(INFO) << "wait for '" << fpInfo << "' took " << timer;
+        return true;
     }
     LOG(ERROR) << "wait for '" << fpInfo << "' timed out and took " << timer;
     return false;
@@ -239,15 +310,163 @@ __attribute__((weak)) bool VerityInfoWrite(const ModuleFile &file)
     return true;
 }
 
-__attribute__((weak)) bool PrepareFileToDestDir(const std::string &pkgPath, const std::string &outPath)
+bool ExtractZipEntryToFile(ModuleZipHelper &helper, const std::string &entryName, const std::string &outFile)
+{
+    if (!helper.LocateFile(entryName)) {
+        return false;
+    }
+    UniqueFd fd(open(outFile.c_str(), O_CREAT | O_TRUNC | O_WRONLY | O_CLOEXEC, EXTRACT_FILE_MODE));
+    if (fd.Get() == -1) {
+        LOG(ERROR) << "Failed to create " << outFile << " err=" << errno;
+        return false;
+    }
+    // reserve the whole file up front so the streamed writes never extend it block by block
+    const ModuleZipEntry *entry = helper.FindEntry(entryName);
+    if (entry != nullptr && entry->uncompressedSize > 0 &&
+        fallocate(fd.Get(), 0, 0, static_cast<off_t>(entry->uncompressedSize)) != 0) {
+        LOG(WARNING) << "Failed to fallocate " << outFile << " err=" << errno;
+    }
+    off_t offset = 0;
+    bool ret = helper.ReadFileChunks([&fd, &offset](const uint8_t *data, size_t size) {
+        if (!WriteFullyAtOffset(fd.Get(), data, size, offset)) {
+            LOG(ERROR) << "Failed to write at " << offset << " err=" << errno;
+            return false;
+        }
+        offset += static_cast<off_t>(size);
+        return true;
+    });
+    if (!ret) {
+        LOG(ERROR) << "Failed to extract " << entryName << " to " << outFile;
+    }
+    return ret;
+}
+
+namespace {
+bool IsSafeEntryName(const std::string &name)
 {
-    if (ExtraPackageDir(pkgPath.c_str(), nullptr, nullptr, outPath.c_str()) != 0) {
+    // a name cut short at an embedded nul would write somewhere else than it claims
+    if (name.empty() || name[0] == '/' || name.find('\0') != std::string::npos) {
+        return false;
+    }
+    for (const auto &part : Utils::SplitString(name, "/")) {
+        if (part == "..") {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool CreateParentDirs(const std::string &outPath, const std::string &name)
+{
+    for (size_t pos = name.find('/'); pos != std::string::npos; pos = name.find('/', pos + 1)) {
+        if (!CreateDirIfNeeded(outPath + name.substr(0, pos), EXTRACT_DIR_MODE)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ExtractZipEntries(const std::string &pkgPath, const std::string &outPath, const std::vector<std::string> &names,
+    const ExtractedCallback &onExtracted, std::atomic<size_t> &next, std::atomic<bool> &failed)
+{
+    // minizip handles are not thread safe, every worker indexes the package on its own
+    ModuleZipHelper helper(pkgPath);
+    if (!helper.IsValid()) {
+        LOG(ERROR) << "Failed to open hmp package " << pkgPath;
+        failed = true;
+        return false;
+    }
+    for (size_t index = next++; index < names.size() && !failed; index = next++) {
+        Timer timer;
+        if (!ExtractZipEntryToFile(helper, names[index], outPath + names[index])) {
+            failed = true;
+            return false;
+        }
+        const ModuleZipEntry *entry = helper.FindEntry(names[index]);
+        LOG(INFO) << "Extract " << names[index] << " size " << (entry == nullptr ? 0 : entry->uncompressedSize) <<
+            " cost " << timer;
+        // runs on this worker while the others keep extracting
+        if (onExtracted && !onExtracted(outPath + names[index])) {
+            failed = true;
+            return false;
+        }
+    }
+    return true;
+}
+}
+
+bool ExtractPackageToDir(const std::string &pkgPath, const std::string &outPath, const ExtractedCallback &onExtracted)
+{
+    // stream every entry through a bounded window, peak memory does not depend on the entry size
+    Timer timer;
+    ModuleZipHelper helper(pkgPath);
+    if (!helper.IsValid()) {
+        LOG(ERROR) << "Failed to open hmp package " << pkgPath;
+        return false;
+    }
+    std::vector<std::string> names;
+    std::vector<std::string> files;
+    helper.GetEntryNames(names);
+    for (const auto &name : names) {
+        if (!IsSafeEntryName(name)) {
+            LOG(ERROR) << "Invalid entry " << name << " in " << pkgPath;
+            return false;
+        }
+        if (!CreateParentDirs(outPath, name)) {
+            LOG(ERROR) << "Failed to create dir for " << name;
+            return false;
+        }
+        if (name.back() != '/') {
+            files.emplace_back(name);
+        }
+    }
+    // module packages first so their callbacks overlap the rest, then largest first so one big image
+    // does not end up last on a single worker
+    std::sort(files.begin(), files.end(), [&helper](const std::string &lhs, const std::string &rhs) {
+        bool lhsModule = CheckFileSuffix(lhs, MODULE_PACKAGE_SUFFIX);
+        bool rhsModule = CheckFileSuffix(rhs, MODULE_PACKAGE_SUFFIX);
+        if (lhsModule != rhsModule) {
+            return lhsModule;
+        }
+        return helper.FindEntry(lhs)->uncompressedSize > helper.FindEntry(rhs)->uncompressedSize;
+    });
+    size_t threadNum = std::min({static_cast<size_t>(std::max(std::thread::hardware_concurrency(), 1U)),
+        MAX_EXTRACT_THREAD_NUM, files.size()});
+    std::atomic<size_t> next {0};
+    std::atomic<bool> failed {false};
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < threadNum; i++) {
+        workers.emplace_back([&pkgPath, &outPath, &files, &onExtracted, &next, &failed] {
+            (void)ExtractZipEntries(pkgPath, outPath, files, onExtracted, next, failed);
+        });
+    }
+    (void)ExtractZipEntries(pkgPath, outPath, files, onExtracted, next, failed);
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    if (failed) {
         LOG(ERROR) << "Failed to unpack hmp package " << pkgPath;
         return false;
     }
+    LOG(INFO) << "Unpack " << files.size() << " files of " << pkgPath << " with " << threadNum << " threads cost " <<
+        timer;
     return true;
 }
 
+extern "C" bool DefaultPrepareFileToDestDir(const std::string &pkgPath, const std::string &outPath)
+{
+    return ExtractPackageToDir(pkgPath, outPath, nullptr);
+}
+
+// an alias instead of a body, so the installer can tell whether a strong definition replaced it
+__attribute__((weak, alias("DefaultPrepareFileToDestDir"))) bool PrepareFileToDestDir(const std::string &pkgPath,
+    const std::string &outPath);
+
+bool IsDefaultPrepareFileToDestDir()
+{
+    return &PrepareFileToDestDir == &DefaultPrepareFileToDestDir;
+}
+
 __attribute__((weak)) void SetModuleVersion(const ModuleFile &file)
 {
     LOG(INFO) << "Set module version.";
@@ -15,7 +15,9 @@
 
 #include "module_zip_helper.h"
 
+#include <algorithm>
 #include <fcntl.h>
+#include <sys/stat.h>
 
 #include "log/log.h"
 #include "module_utils.h"
@@ -62,18 +64,33 @@ struct __attribute__((packed)) CentralDirEntry {
 
 constexpr uint32_t LOCAL_HEADER_SIGNATURE = 0x04034b50;
 constexpr uint32_t CENTRAL_SIGNATURE = 0x02014b50;
+constexpr uint32_t END_OF_CENTRAL_SIGNATURE = 0x06054b50;
+constexpr uint32_t ZIP64_MARKER = 0xFFFFFFFF;
+constexpr uint16_t ZIP_METHOD_STORED = 0;
+constexpr size_t END_OF_CENTRAL_SIZE = 22;
+constexpr size_t END_OF_CENTRAL_ENTRY_NUM = 10;
+constexpr size_t END_OF_CENTRAL_DIR_SIZE = 12;
+constexpr size_t END_OF_CENTRAL_DIR_OFFSET = 16;
+constexpr size_t MAX_COMMENT_SIZE = 0xFFFF;
+constexpr uint32_t INFLATE_STEP_SIZE = 1024 * 1024;
 }
 
 ModuleZipHelper::ModuleZipHelper(const std::string &path)
 {
-    handle_ = unzOpen(path.c_str());
-    hasLocated_ = false;
     zipPath_ = path;
+    handle_ = unzOpen(path.c_str());
+    if (handle_ == nullptr) {
+        return;
+    }
+    if (!BuildIndex()) {
+        LOG(ERROR) << "Failed to build zip index. path=" << zipPath_;
+        fd_ = UniqueFd(-1);
+    }
 }
 
 ModuleZipHelper::~ModuleZipHelper()
 {
-    if (IsValid()) {
+    if (handle_ != nullptr) {
         int err = unzClose(handle_);
         if (err != UNZ_OK) {
             LOG(WARNING) << "Close handle error " << err << ". path=" << zipPath_;
@@ -81,136 +98,326 @@ ModuleZipHelper::~ModuleZipHelper()
     }
 }
 
+bool ModuleZipHelper::BuildIndex()
+{
+    std::string realPath = GetRealPath(zipPath_);
+    if (realPath.empty()) {
+        LOG(ERROR) << "Invalid path " << zipPath_;
+        return false;
+    }
+    fd_ = UniqueFd(open(realPath.c_str(), O_RDONLY | O_CLOEXEC));
+    if (fd_.Get() == -1) {
+        LOG(ERROR) << "Cannot open package " << zipPath_;
+        return false;
+    }
+    struct stat st {};
+    if (fstat(fd_.Get(), &st) != 0 || static_cast<uint64_t>(st.st_size) < END_OF_CENTRAL_SIZE ||
+        static_cast<uint64_t>(st.st_size) > ZIP64_MARKER) {
+        LOG(ERROR) << "Invalid package size " << zipPath_;
+        return false;
+    }
+    // end of central directory record sits at the tail, followed by an optional comment
+    size_t fileSize = static_cast<size_t>(st.st_size);
+    size_t tailSize = std::min(fileSize, END_OF_CENTRAL_SIZE + MAX_COMMENT_SIZE);
+    std::vector<uint8_t> tail(tailSize);
+    if (!ReadFullyAtOffset(fd_.Get(), tail.data(), tailSize, fileSize - tailSize)) {
+        LOG(ERROR) << "Unable to read end of central directory";
+        return false;
+    }
+    size_t pos = tailSize - END_OF_CENTRAL_SIZE + 1;
+    do {
+        pos--;
+        if (ReadLE32(tail.data() + pos) == END_OF_CENTRAL_SIGNATURE) {
+            break;
+        }
+    } while (pos > 0);
+    if (ReadLE32(tail.data() + pos) != END_OF_CENTRAL_SIGNATURE) {
+        LOG(ERROR) << "Check end of central directory signature error";
+        return false;
+    }
+    uint32_t entryNum = ReadLE16(tail.data() + pos + END_OF_CENTRAL_ENTRY_NUM);
+    uint32_t centralDirSize = ReadLE32(tail.data() + pos + END_OF_CENTRAL_DIR_SIZE);
+    uint32_t centralDirOffset = ReadLE32(tail.data() + pos + END_OF_CENTRAL_DIR_OFFSET);
+    size_t endOfCentralOffset = fileSize - tailSize + pos;
+    if (static_cast<uint64_t>(centralDirOffset) + centralDirSize > endOfCentralOffset) {
+        LOG(ERROR) << "Invalid central directory, offset " << centralDirOffset << " size " << centralDirSize;
+        return false;
+    }
+    std::vector<uint8_t> centralDir(centralDirSize);
+    if (!ReadFullyAtOffset(fd_.Get(), centralDir.data(), centralDirSize, centralDirOffset)) {
+        LOG(ERROR) << "Unable to read central directory";
+        return false;
+    }
+    return ParseCentralDir(centralDir, centralDirOffset, entryNum);
+}
+
+bool ModuleZipHelper::ParseCentralDir(const std::vector<uint8_t> &centralDir, uint32_t centralDirOffset,
+    uint32_t entryNum)
+{
+    entries_.clear();
+    entries_.reserve(entryNum);
+    size_t pos = 0;
+    for (uint32_t i = 0; i < entryNum; i++) {
+        if (pos + sizeof(CentralDirEntry) > centralDir.size()) {
+            LOG(ERROR) << "Central directory truncated at entry " << i;
+            return false;
+        }
+        const uint8_t *buf = centralDir.data() + pos;
+        if (ReadLE32(buf + offsetof(CentralDirEntry, signature)) != CENTRAL_SIGNATURE) {
+            LOG(ERROR) << "Check central signature error at entry " << i;
+            return false;
+        }
+        uint16_t nameSize = ReadLE16(buf + offsetof(CentralDirEntry, nameSize));
+        size_t entrySize = sizeof(CentralDirEntry) + nameSize + ReadLE16(buf + offsetof(CentralDirEntry, extraSize)) +
+            ReadLE16(buf + offsetof(CentralDirEntry, commentSize));
+        if (pos + entrySize > centralDir.size()) {
+            LOG(ERROR) << "Central directory entry " << i << " out of range";
+            return false;
+        }
+        ModuleZipEntry entry;
+        entry.index = i;
+        entry.centralDirOffset = centralDirOffset + static_cast<uint32_t>(pos);
+        entry.localHeaderOffset = ReadLE32(buf + offsetof(CentralDirEntry, localHeaderOffset));
+        entry.compressedSize = ReadLE32(buf + offsetof(CentralDirEntry, compressedSize));
+        entry.uncompressedSize = ReadLE32(buf + offsetof(CentralDirEntry, uncompressedSize));
+        entry.crc = ReadLE32(buf + offsetof(CentralDirEntry, crc));
+        entry.method = ReadLE16(buf + offsetof(CentralDirEntry, compressionMethod));
+        if (entry.compressedSize == ZIP64_MARKER || entry.uncompressedSize == ZIP64_MARKER ||
+            entry.localHeaderOffset == ZIP64_MARKER) {
+            LOG(ERROR) << "Zip64 entry is not supported, entry " << i;
+            return false;
+        }
+        // keep the first one like unzLocateFile does
+        entries_.emplace(std::string(reinterpret_cast<const char *>(buf + sizeof(CentralDirEntry)), nameSize), entry);
+        pos += entrySize;
+    }
+    entryNum_ = entryNum;
+    return true;
+}
+
 bool ModuleZipHelper::GetNumberOfEntry(uint32_t &number)
 {
     if (!IsValid()) {
         LOG(ERROR) << "Cannot get entry number with invalid handle. path=" << zipPath_;
         return false;
     }
-    unz_global_info info;
-    int err = unzGetGlobalInfo(handle_, &info);
-    if (err != UNZ_OK) {
-        LOG(ERROR) << "Get global info error " << err << ". path=" << zipPath_;
-        return false;
-    }
-    number = static_cast<uint32_t>(info.number_entry);
+    number = entryNum_;
     return true;
 }
 
+const ModuleZipEntry *ModuleZipHelper::FindEntry(const std::string &fpInfo) const
+{
+    auto iter = entries_.find(fpInfo);
+    return iter == entries_.end() ? nullptr : &iter->second;
+}
+
 bool ModuleZipHelper::LocateFile(const std::string &fpInfo)
 {
     if (!IsValid()) {
         LOG(ERROR) << "Cannot locate file with invalid handle. path=" << zipPath_;
         return false;
     }
-    int err = unzLocateFile2(handle_, fpInfo.c_str(), 0);
-    if (err != UNZ_OK) {
+    auto iter = entries_.find(fpInfo);
+    if (iter == entries_.end()) {
         LOG(ERROR) << fpInfo << " is not found in " << zipPath_;
-        hasLocated_ = false;
+        located_ = nullptr;
         return false;
     }
-    hasLocated_ = true;
+    located_ = &iter->second;
     filename_ = fpInfo;
     return true;
 }
 
 bool ModuleZipHelper::GetFileSize(uint32_t &size)
 {
-    if (!hasLocated_) {
+    if (located_ == nullptr) {
         LOG(ERROR) << "Cannot get file size without located file. path=" << zipPath_;
         return false;
     }
-    unz_file_info info;
-    int err = unzGetCurrentFileInfo(handle_, &info, nullptr, 0, nullptr, 0, nullptr, 0);
-    if (err != UNZ_OK) {
-        LOG(ERROR) << "Get file size error " << err << ". " << filename_ << " in " << zipPath_;
-        return false;
-    }
-    size = static_cast<uint32_t>(info.uncompressed_size);
+    size = located_->uncompressedSize;
     return true;
 }
 
 bool ModuleZipHelper::GetFileOffset(uint32_t &offset)
 {
-    if (!hasLocated_) {
+    if (located_ == nullptr) {
         LOG(ERROR) << "Cannot get file offset without located file. path=" << zipPath_;
         return false;
     }
-    unz_file_pos filePos;
-    int err = unzGetFilePos(handle_, &filePos);
-    if (err != UNZ_OK) {
-        LOG(ERROR) << "Get file pos error " << err << ". " << filename_ << " in " << zipPath_;
+    if (!GetFileEntryOffset(*located_)) {
+        LOG(ERROR) << "Cannot get file entry offset";
         return false;
     }
-    uint32_t centralDirOffset = static_cast<uint32_t>(filePos.pos_in_zip_directory);
-    if (!GetFileEntryOffset(offset, centralDirOffset)) {
-        LOG(ERROR) << "Cannot get file entry offset";
+    offset = located_->dataOffset;
+    return true;
+}
+
+bool ModuleZipHelper::GetFileEntryOffset(ModuleZipEntry &entry) const
+{
+    if (entry.dataOffset != 0) {
+        return true;
+    }
+    uint8_t localHeaderBuf[sizeof(LocalFileHeader)];
+    if (!ReadFullyAtOffset(fd_.Get(), localHeaderBuf, sizeof(LocalFileHeader), entry.localHeaderOffset)) {
+        LOG(ERROR) << "Unable to read local file header";
         return false;
     }
+    uint32_t localHeaderSignature = ReadLE32(localHeaderBuf + offsetof(LocalFileHeader, signature));
+    if (localHeaderSignature != LOCAL_HEADER_SIGNATURE) {
+        LOG(ERROR) << "Check local header signature error";
+        return false;
+    }
+    uint16_t nameSize = ReadLE16(localHeaderBuf + offsetof(LocalFileHeader, nameSize));
+    uint16_t extraSize = ReadLE16(localHeaderBuf + offsetof(LocalFileHeader, extraSize));
+    entry.dataOffset = entry.localHeaderOffset + sizeof(LocalFileHeader) + nameSize + extraSize;
     return true;
 }
 
-bool ModuleZipHelper::GetFileEntryOffset(uint32_t &offset, uint32_t centralDirOffset) const
+bool ModuleZipHelper::IsStored(const ModuleZipEntry &entry) const
 {
-    std::string realPath = GetRealPath(zipPath_);
-    if (realPath.empty()) {
-        LOG(ERROR) << "Invalid path " << zipPath_;
+    return entry.method == ZIP_METHOD_STORED && entry.compressedSize == entry.uncompressedSize;
+}
+
+bool ModuleZipHelper::ReadFileContent(uint8_t *buffer, size_t size)
+{
+    if (located_ == nullptr) {
+        LOG(ERROR) << "Cannot read file content without located file. path=" << zipPath_;
         return false;
     }
-    UniqueFd fd(open(realPath.c_str(), O_RDONLY | O_CLOEXEC));
-    if (fd.Get() == -1) {
-        LOG(ERROR) << "Cannot open package " << zipPath_;
+    uint32_t length = located_->uncompressedSize;
+    if (buffer == nullptr || size < length) {
+        LOG(ERROR) << "Buffer too small " << size << " for " << filename_ << " of size " << length;
         return false;
     }
-    uint8_t centralDirBuf[sizeof(CentralDirEntry)];
-    if (!ReadFullyAtOffset(fd.Get(), centralDirBuf, sizeof(CentralDirEntry), centralDirOffset)) {
-        LOG(ERROR) << "Unable to read central directory";
+    if (length == 0) {
+        return true;
+    }
+    // stored entries are read straight from the package, no need to go through minizip
+    if (IsStored(*located_) && GetFileEntryOffset(*located_)) {
+        if (!ReadFullyAtOffset(fd_.Get(), buffer, length, located_->dataOffset)) {
+            LOG(ERROR) << "Read stored file error. " << filename_ << " in " << zipPath_;
+            return false;
+        }
+        // minizip checks the crc on close, the direct read has to do it itself
+        uLong crc = crc32(crc32(0L, Z_NULL, 0), buffer, length);
+        if (crc != located_->crc) {
+            LOG(ERROR) << "Crc mismatch " << crc << " != " << located_->crc << ". " << filename_ << " in " << zipPath_;
+            return false;
+        }
+        return true;
+    }
+    return InflateFileContent(buffer, length);
+}
+
+bool ModuleZipHelper::InflateFileContent(uint8_t *buffer, uint32_t length)
+{
+    unz_file_pos filePos;
+    filePos.pos_in_zip_directory = located_->centralDirOffset;
+    filePos.num_of_file = located_->index;
+    int err = unzGoToFilePos(handle_, &filePos);
+    if (err != UNZ_OK) {
+        LOG(ERROR) << "Go to file pos error " << err << ". " << filename_ << " in " << zipPath_;
         return false;
     }
-    uint32_t centralSignature = ReadLE32(centralDirBuf + offsetof(CentralDirEntry, signature));
-    if (centralSignature != CENTRAL_SIGNATURE) {
-        LOG(ERROR) << "Check central signature error";
+    err = unzOpenCurrentFile(handle_);
+    if (err != UNZ_OK) {
+        LOG(ERROR) << "Open current file error " << err << ". " << filename_ << " in " << zipPath_;
         return false;
     }
-    uint32_t localHeaderOffset = ReadLE32(centralDirBuf + offsetof(CentralDirEntry, localHeaderOffset));
-    uint8_t localHeaderBuf[sizeof(LocalFileHeader)];
-    if (!ReadFullyAtOffset(fd.Get(), localHeaderBuf, sizeof(LocalFileHeader), localHeaderOffset)) {
-        LOG(ERROR) << "Unable to read local file header";
+    // inflate in bounded steps straight into the caller buffer
+    uint32_t total = 0;
+    int size = 0;
+    while (total < length) {
+        uint32_t step = std::min(length - total, INFLATE_STEP_SIZE);
+        size = unzReadCurrentFile(handle_, reinterpret_cast<void *>(buffer + total), step);
+        if (size <= 0) {
+            break;
+        }
+        total += static_cast<uint32_t>(size);
+    }
+    err = unzCloseCurrentFile(handle_);
+    if (size < 0 || total != length) {
+        LOG(ERROR) << "Read current file error " << size << ". " << filename_ << " in " << zipPath_;
         return false;
     }
-    uint32_t localHeaderSignature = ReadLE32(localHeaderBuf + offsetof(LocalFileHeader, signature));
-    if (localHeaderSignature != LOCAL_HEADER_SIGNATURE) {
-        LOG(ERROR) << "Check local header signature error";
+    if (err != UNZ_OK) {
+        LOG(ERROR) << "Close current file error " << err << ". " << filename_ << " in " << zipPath_;
         return false;
     }
-    uint16_t nameSize = ReadLE16(localHeaderBuf + offsetof(LocalFileHeader, nameSize));
-    uint16_t extraSize = ReadLE16(localHeaderBuf + offsetof(LocalFileHeader, extraSize));
-    offset = localHeaderOffset + sizeof(LocalFileHeader) + nameSize + extraSize;
     return true;
 }
 
-bool ModuleZipHelper::GetFileContent(std::string &buf)
+bool ModuleZipHelper::ReadFileChunks(const ChunkConsumer &consumer, size_t windowSize)
 {
-    if (!hasLocated_) {
-        LOG(ERROR) << "Cannot get file content without located file. path=" << zipPath_;
+    if (located_ == nullptr) {
+        LOG(ERROR) << "Cannot read file chunks without located file. path=" << zipPath_;
         return false;
     }
-    uint32_t length;
-    if (!GetFileSize(length)) {
-        LOG(ERROR) << "Cannot get buf length.";
+    if (!consumer || windowSize == 0) {
+        LOG(ERROR) << "Invalid chunk consumer or window size " << windowSize;
         return false;
     }
-    buf.resize(length, '\0');
+    uint32_t length = located_->uncompressedSize;
+    windowSize = std::min(windowSize, static_cast<size_t>(std::max(length, 1U)));
+    std::vector<uint8_t> window(windowSize);
+    if (IsStored(*located_) && GetFileEntryOffset(*located_)) {
+        uLong crc = crc32(0L, Z_NULL, 0);
+        for (uint32_t total = 0; total < length;) {
+            uint32_t step = static_cast<uint32_t>(std::min(static_cast<size_t>(length - total), windowSize));
+            if (!ReadFullyAtOffset(fd_.Get(), window.data(), step, located_->dataOffset + total)) {
+                LOG(ERROR) << "Read stored file error. " << filename_ << " in " << zipPath_;
+                return false;
+            }
+            crc = crc32(crc, window.data(), step);
+            if (!consumer(window.data(), step)) {
+                LOG(ERROR) << "Chunk consumer failed at " << total << ". " << filename_ << " in " << zipPath_;
+                return false;
+            }
+            total += step;
+        }
+        // like unzCloseCurrentFile, the mismatch only shows once the consumer has seen everything
+        if (crc != located_->crc) {
+            LOG(ERROR) << "Crc mismatch " << crc << " != " << located_->crc << ". " << filename_ << " in " << zipPath_;
+            return false;
+        }
+        return true;
+    }
+    return InflateFileChunks(consumer, window);
+}
 
-    int err = unzOpenCurrentFile(handle_);
+bool ModuleZipHelper::InflateFileChunks(const ChunkConsumer &consumer, std::vector<uint8_t> &window)
+{
+    unz_file_pos filePos;
+    filePos.pos_in_zip_directory = located_->centralDirOffset;
+    filePos.num_of_file = located_->index;
+    int err = unzGoToFilePos(handle_, &filePos);
+    if (err != UNZ_OK) {
+        LOG(ERROR) << "Go to file pos error " << err << ". " << filename_ << " in " << zipPath_;
+        return false;
+    }
+    err = unzOpenCurrentFile(handle_);
     if (err != UNZ_OK) {
         LOG(ERROR) << "Open current file error " << err << ". " << filename_ << " in " << zipPath_;
         return false;
     }
-    int size = unzReadCurrentFile(handle_, reinterpret_cast<void *>(&(buf)[0]), length);
+    uint64_t total = 0;
+    int size = 0;
+    bool consumed = true;
+    while ((size = unzReadCurrentFile(handle_, window.data(), static_cast<unsigned>(window.size()))) > 0) {
+        if (!consumer(window.data(), static_cast<size_t>(size))) {
+            consumed = false;
+            break;
+        }
+        total += static_cast<uint64_t>(size);
+    }
+    // close also checks the crc once the whole entry was read
     err = unzCloseCurrentFile(handle_);
-    if (size < 0) {
-        LOG(ERROR) << "Read current file error. " << filename_ << " in " << zipPath_;
+    if (!consumed) {
+        LOG(ERROR) << "Chunk consumer failed at " << total << ". " << filename_ << " in " << zipPath_;
+        return false;
+    }
+    if (size < 0 || total != located_->uncompressedSize) {
+        LOG(ERROR) << "Read current file error " << size << ". " << filename_ << " in " << zipPath_;
         return false;
     }
     if (err != UNZ_OK) {
@@ -219,5 +426,24 @@ bool ModuleZipHelper::GetFileContent(std::string &buf)
     }
     return true;
 }
+
+void ModuleZipHelper::GetEntryNames(std::vector<std::string> &names) const
+{
+    names.clear();
+    names.reserve(entries_.size());
+    for (const auto &[name, entry] : entries_) {
+        names.emplace_back(name);
+    }
+}
+
+bool ModuleZipHelper::GetFileContent(std::string &buf)
+{
+    if (located_ == nullptr) {
+        LOG(ERROR) << "Cannot get file content without located file. path=" << zipPath_;
+        return false;
+    }
+    buf.resize(located_->uncompressedSize, '\0');
+    return ReadFileContent(reinterpret_cast<uint8_t *>(&buf[0]), buf.size());
+}
 } // namespace SysInstaller
-} // namespace OHOS
\ No newline at end of file
+} // namespace OHOS
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SYS_INSTALLER_STREAM_CHECKPOINT_H
+#define SYS_INSTALLER_STREAM_CHECKPOINT_H
+
+#include <cstdint>
+#include <string>
+
+namespace OHOS {
+namespace SysInstaller {
+constexpr const char *STREAM_CHECKPOINT_PATH = "/data/updater/stream_update_checkpoint";
+constexpr uint64_t STREAM_CHECKPOINT_INTERVAL = 16 * 1024 * 1024;
+constexpr const char *STREAM_PARTITION_DIR = "/dev/block/by-name";
+
+// state of a stream session at a point a new parser can start from: every byte before committedOffset was
+// accepted by the writer and none of it is still buffered in the parser
+struct StreamCheckpoint {
+    uint64_t committedOffset = 0;
+    uint32_t slotSize = 0;
+};
+
+// fdatasync of every partition in dir whose name ends with suffix, i.e. the partitions of one slot
+bool SyncSlotPartitions(const std::string &dir, const std::string &suffix);
+
+// One record file, replaced atomically (write tmp, fsync, rename) so a crash leaves either the old or the new
+// checkpoint on disk, never a torn one.
+class StreamCheckpointJournal {
+public:
+    explicit StreamCheckpointJournal(const std::string &path = STREAM_CHECKPOINT_PATH) : path_(path) {}
+    ~StreamCheckpointJournal() = default;
+
+    bool Save(const StreamCheckpoint &checkpoint);
+    bool Load(StreamCheckpoint &checkpoint) const;
+    void Clear();
+    void SetPath(const std::string &path)
+    {
+        path_ = path;
+    }
+
+private:
+    std::string path_;
+};
+} // SysInstaller
+} // namespace OHOS
+#endif // SYS_INSTALLER_STREAM_CHECKPOINT_H
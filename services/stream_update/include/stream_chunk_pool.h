@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SYS_INSTALLER_STREAM_CHUNK_POOL_H
+#define SYS_INSTALLER_STREAM_CHUNK_POOL_H
+
+#include <cstdint>
+#include <vector>
+#include "macros_updater.h"
+#include "stream_spsc_ring.h"
+
+namespace OHOS {
+namespace SysInstaller {
+struct StreamChunk {
+    uint8_t *data = nullptr;
+    uint32_t capacity = 0;
+    uint32_t len = 0;
+};
+
+// Fixed set of page aligned chunk buffers. The producer fills a free chunk and submits it,
+// the consumer pops it and releases it back when done, chunks change hands without copying.
+// Acquire/TryAcquire/Cancel/Submit belong to one producer thread at a time, Pop/Release to one consumer thread.
+class StreamChunkPool {
+    DISALLOW_COPY_MOVE(StreamChunkPool);
+public:
+    StreamChunkPool() = default;
+    ~StreamChunkPool();
+
+    bool Init(uint32_t chunkSize, uint32_t chunkNum);
+    void Stop();
+    void Reset();
+
+    StreamChunk *Acquire();
+    // nullptr instead of waiting when all chunks are in flight
+    StreamChunk *TryAcquire();
+    // hands an acquired but unused chunk back to the producer side, the next Acquire returns it again
+    void Cancel(StreamChunk *chunk);
+    void Submit(StreamChunk *chunk);
+    StreamChunk *Pop();
+    void Release(StreamChunk *chunk);
+
+    uint32_t GetChunkSize() const
+    {
+        return chunkSize_;
+    }
+    uint32_t GetFreeNum()
+    {
+        return static_cast<uint32_t>(freeQueue_.Size());
+    }
+    bool IsStopped()
+    {
+        return freeQueue_.IsStopped();
+    }
+
+private:
+    void FreeMemory();
+
+    uint8_t *memory_ = nullptr;
+    uint32_t chunkSize_ = 0;
+    uint32_t chunkNum_ = 0;
+    std::vector<StreamChunk> chunks_ {};
+    StreamChunk *spareChunk_ = nullptr;
+    StreamSpscRing<StreamChunk *> freeQueue_ {};
+    StreamSpscRing<StreamChunk *> readyQueue_ {};
+};
+} // SysInstaller
+} // namespace OHOS
+#endif // SYS_INSTALLER_STREAM_CHUNK_POOL_H
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SYS_INSTALLER_STREAM_LOG_SAMPLER_H
+#define SYS_INSTALLER_STREAM_LOG_SAMPLER_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace OHOS {
+namespace SysInstaller {
+constexpr uint32_t STREAM_LOG_INTERVAL_MS = 5000;
+
+// Aggregates the per chunk events of the stream data path and writes one summary line
+// (chunks/s, MB/s) per interval instead of a log line per chunk. Used by a single thread.
+class StreamLogSampler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit StreamLogSampler(const std::string &tag, uint32_t intervalMs = STREAM_LOG_INTERVAL_MS)
+        : tag_(tag), interval_(std::chrono::milliseconds(intervalMs)) {}
+    ~StreamLogSampler() = default;
+
+    void Reset();
+    // returns true when a summary line was written
+    bool OnChunk(uint64_t bytes)
+    {
+        windowChunks_++;
+        windowBytes_ += bytes;
+        Clock::time_point now = Clock::now();
+        if (now - windowStart_ < interval_) {
+            return false;
+        }
+        Report(now, false);
+        return true;
+    }
+    void Flush();
+
+    uint64_t GetTotalChunks() const
+    {
+        return totalChunks_ + windowChunks_;
+    }
+
+private:
+    void Report(Clock::time_point now, bool isFinal);
+
+    std::string tag_;
+    Clock::duration interval_;
+    Clock::time_point sessionStart_ = Clock::now();
+    Clock::time_point windowStart_ = sessionStart_;
+    uint64_t windowChunks_ = 0;
+    uint64_t windowBytes_ = 0;
+    uint64_t totalChunks_ = 0;
+    uint64_t totalBytes_ = 0;
+};
+} // SysInstaller
+} // namespace OHOS
+#endif // SYS_INSTALLER_STREAM_LOG_SAMPLER_H
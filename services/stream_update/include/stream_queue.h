@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SYS_INSTALLER_STREAM_QUEUE_H
+#define SYS_INSTALLER_STREAM_QUEUE_H
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include "macros_updater.h"
+
+namespace OHOS {
+namespace SysInstaller {
+// Bounded blocking queue between two stream pipeline stages.
+// Stop() aborts both sides at once, Close() refuses new items but lets the consumer drain.
+template<typename T>
+class StreamQueue {
+    DISALLOW_COPY_MOVE(StreamQueue);
+public:
+    StreamQueue() = default;
+    ~StreamQueue() = default;
+
+    void Init(size_t capacity)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        capacity_ = capacity;
+        items_.clear();
+        isStop_ = false;
+        isClose_ = false;
+    }
+
+    bool Push(T item)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        notFullCv_.wait(lock, [this] { return isStop_ || isClose_ || items_.size() < capacity_; });
+        if (isStop_ || isClose_) {
+            return false;
+        }
+        items_.push_back(std::move(item));
+        notEmptyCv_.notify_one();
+        return true;
+    }
+
+    bool Pop(T &item)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        notEmptyCv_.wait(lock, [this] { return isStop_ || isClose_ || !items_.empty(); });
+        if (isStop_ || items_.empty()) {
+            return false;
+        }
+        item = std::move(items_.front());
+        items_.pop_front();
+        notFullCv_.notify_one();
+        return true;
+    }
+
+    // never waits, false when the queue is empty or stopped
+    bool TryPop(T &item)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (isStop_ || items_.empty()) {
+            return false;
+        }
+        item = std::move(items_.front());
+        items_.pop_front();
+        notFullCv_.notify_one();
+        return true;
+    }
+
+    bool IsStopped()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return isStop_;
+    }
+
+    size_t Size()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return items_.size();
+    }
+
+    void Stop()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        isStop_ = true;
+        notFullCv_.notify_all();
+        notEmptyCv_.notify_all();
+    }
+
+    void Close()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        isClose_ = true;
+        notFullCv_.notify_all();
+        notEmptyCv_.notify_all();
+    }
+
+    void Clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        items_.clear();
+    }
+
+private:
+    std::deque<T> items_ {};
+    size_t capacity_ = 0;
+    std::mutex mutex_;
+    std::condition_variable notFullCv_;
+    std::condition_variable notEmptyCv_;
+    bool isStop_ = false;
+    bool isClose_ = false;
+};
+} // SysInstaller
+} // namespace OHOS
+#endif // SYS_INSTALLER_STREAM_QUEUE_H
@@ -0,0 +1,259 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SYS_INSTALLER_STREAM_SPSC_RING_H
+#define SYS_INSTALLER_STREAM_SPSC_RING_H
+
+#include <atomic>
+#include <cstdint>
+#include <initializer_list>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include "macros_updater.h"
+
+namespace OHOS {
+namespace SysInstaller {
+constexpr size_t STREAM_CACHE_LINE_SIZE = 64;
+constexpr uint32_t STREAM_SPSC_YIELD_NUM = 4;
+
+// Bounded ring for exactly one producer thread and one consumer thread at a time.
+// Push and Pop are wait-free while the ring is neither full nor empty; only then the caller parks on a futex,
+// and the other side issues a wake syscall only when somebody is actually parked.
+// Same Stop/Close semantics as StreamQueue: Stop aborts both sides, Close lets the consumer drain.
+template<typename T>
+class StreamSpscRing {
+    DISALLOW_COPY_MOVE(StreamSpscRing);
+public:
+    StreamSpscRing() = default;
+    ~StreamSpscRing() = default;
+
+    // not thread safe, both sides must be idle
+    void Init(size_t capacity)
+    {
+        size_t size = 1;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        slots_.assign(size, T {});
+        mask_ = size - 1;
+        capacity_ = capacity;
+        head_.value.store(0, std::memory_order_relaxed);
+        tail_.value.store(0, std::memory_order_relaxed);
+        producer_.cachedHead = 0;
+        consumer_.cachedTail = 0;
+        isStop_.store(false, std::memory_order_relaxed);
+        isClose_.store(false, std::memory_order_relaxed);
+    }
+
+    bool Push(T item)
+    {
+        uint64_t tail = tail_.value.load(std::memory_order_relaxed);
+        while (true) {
+            if (isStop_.load(std::memory_order_acquire) || isClose_.load(std::memory_order_acquire)) {
+                return false;
+            }
+            if (tail - producer_.cachedHead < capacity_) {
+                break;
+            }
+            producer_.cachedHead = head_.value.load(std::memory_order_acquire);
+            if (tail - producer_.cachedHead < capacity_) {
+                break;
+            }
+            Park(producerWaiting_, popSeq_, [this, tail] {
+                return tail - head_.value.load(std::memory_order_seq_cst) < capacity_;
+            });
+        }
+        slots_[tail & mask_] = std::move(item);
+        tail_.value.store(tail + 1, std::memory_order_release);
+        Notify(pushSeq_, consumerWaiting_);
+        return true;
+    }
+
+    bool Pop(T &item)
+    {
+        uint64_t head = head_.value.load(std::memory_order_relaxed);
+        while (true) {
+            if (isStop_.load(std::memory_order_acquire)) {
+                return false;
+            }
+            if (head != consumer_.cachedTail) {
+                break;
+            }
+            consumer_.cachedTail = tail_.value.load(std::memory_order_acquire);
+            if (head != consumer_.cachedTail) {
+                break;
+            }
+            if (isClose_.load(std::memory_order_acquire)) {
+                // Close may have raced with a last Push, drain it before giving up
+                consumer_.cachedTail = tail_.value.load(std::memory_order_acquire);
+                if (head != consumer_.cachedTail) {
+                    break;
+                }
+                return false;
+            }
+            Park(consumerWaiting_, pushSeq_, [this, head] {
+                return head != tail_.value.load(std::memory_order_seq_cst);
+            });
+        }
+        item = std::move(slots_[head & mask_]);
+        head_.value.store(head + 1, std::memory_order_release);
+        NotifyProducer(head + 1);
+        return true;
+    }
+
+    // never waits, false when the ring is empty or stopped
+    bool TryPop(T &item)
+    {
+        if (isStop_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        uint64_t head = head_.value.load(std::memory_order_relaxed);
+        if (head == consumer_.cachedTail) {
+            consumer_.cachedTail = tail_.value.load(std::memory_order_acquire);
+            if (head == consumer_.cachedTail) {
+                return false;
+            }
+        }
+        item = std::move(slots_[head & mask_]);
+        head_.value.store(head + 1, std::memory_order_release);
+        NotifyProducer(head + 1);
+        return true;
+    }
+
+    void Stop()
+    {
+        isStop_.store(true, std::memory_order_seq_cst);
+        WakeAll();
+    }
+
+    void Close()
+    {
+        isClose_.store(true, std::memory_order_seq_cst);
+        WakeAll();
+    }
+
+    // not thread safe, both sides must be idle
+    void Clear()
+    {
+        for (auto &slot : slots_) {
+            slot = T {};
+        }
+        head_.value.store(0, std::memory_order_relaxed);
+        tail_.value.store(0, std::memory_order_relaxed);
+        producer_.cachedHead = 0;
+        consumer_.cachedTail = 0;
+    }
+
+    bool IsStopped() const
+    {
+        return isStop_.load(std::memory_order_acquire);
+    }
+
+    size_t Size() const
+    {
+        uint64_t head = head_.value.load(std::memory_order_acquire);
+        uint64_t tail = tail_.value.load(std::memory_order_acquire);
+        return tail > head ? static_cast<size_t>(tail - head) : 0;
+    }
+
+private:
+    struct alignas(STREAM_CACHE_LINE_SIZE) PaddedIndex {
+        std::atomic<uint64_t> value { 0 };
+    };
+    struct alignas(STREAM_CACHE_LINE_SIZE) ProducerState {
+        uint64_t cachedHead = 0;
+    };
+    struct alignas(STREAM_CACHE_LINE_SIZE) ConsumerState {
+        uint64_t cachedTail = 0;
+    };
+    struct alignas(STREAM_CACHE_LINE_SIZE) FutexWord {
+        std::atomic<uint32_t> value { 0 };
+    };
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex word must be a plain 32 bit int");
+
+    // seq_cst pairs with Notify: either the waker sees the waiting flag, or the sequence read here already
+    // includes its update and FUTEX_WAIT returns at once
+    template<typename Ready>
+    void Park(FutexWord &waiting, FutexWord &seq, Ready ready)
+    {
+        // the other side is usually mid-operation, give it a few time slices before paying for two syscalls
+        for (uint32_t i = 0; i < STREAM_SPSC_YIELD_NUM; i++) {
+            std::this_thread::yield();
+            if (ready()) {
+                return;
+            }
+        }
+        waiting.value.store(1, std::memory_order_seq_cst);
+        uint32_t expect = seq.value.load(std::memory_order_seq_cst);
+        if (!ready() && !isStop_.load(std::memory_order_seq_cst) && !isClose_.load(std::memory_order_seq_cst)) {
+            (void)syscall(SYS_futex, reinterpret_cast<uint32_t *>(&seq.value), FUTEX_WAIT_PRIVATE, expect,
+                nullptr, nullptr, 0);
+        }
+        waiting.value.store(0, std::memory_order_relaxed);
+    }
+
+    void Notify(FutexWord &seq, FutexWord &waiting)
+    {
+        seq.value.fetch_add(1, std::memory_order_seq_cst);
+        if (waiting.value.load(std::memory_order_seq_cst) != 0) {
+            (void)syscall(SYS_futex, reinterpret_cast<uint32_t *>(&seq.value), FUTEX_WAKE_PRIVATE, 1,
+                nullptr, nullptr, 0);
+        }
+    }
+
+    // a parked producer is only woken once half of the ring is free again, so it refills in one go instead of
+    // bouncing between the two threads for every single slot
+    void NotifyProducer(uint64_t head)
+    {
+        popSeq_.value.fetch_add(1, std::memory_order_seq_cst);
+        if (producerWaiting_.value.load(std::memory_order_seq_cst) == 0) {
+            return;
+        }
+        uint64_t tail = tail_.value.load(std::memory_order_acquire);
+        if (tail - head <= capacity_ / 2) {
+            (void)syscall(SYS_futex, reinterpret_cast<uint32_t *>(&popSeq_.value), FUTEX_WAKE_PRIVATE, 1,
+                nullptr, nullptr, 0);
+        }
+    }
+
+    void WakeAll()
+    {
+        for (FutexWord *seq : { &pushSeq_, &popSeq_ }) {
+            seq->value.fetch_add(1, std::memory_order_seq_cst);
+            (void)syscall(SYS_futex, reinterpret_cast<uint32_t *>(&seq->value), FUTEX_WAKE_PRIVATE, INT32_MAX,
+                nullptr, nullptr, 0);
+        }
+    }
+
+    PaddedIndex head_ {};
+    PaddedIndex tail_ {};
+    ProducerState producer_ {};
+    ConsumerState consumer_ {};
+    FutexWord pushSeq_ {};
+    FutexWord popSeq_ {};
+    FutexWord producerWaiting_ {};
+    FutexWord consumerWaiting_ {};
+    std::atomic<bool> isStop_ { false };
+    std::atomic<bool> isClose_ { false };
+    std::vector<T> slots_ {};
+    uint64_t mask_ = 0;
+    uint64_t capacity_ = 0;
+};
+} // SysInstaller
+} // namespace OHOS
+#endif // SYS_INSTALLER_STREAM_SPSC_RING_H
@@ -18,12 +18,25 @@
 
 #include "stream_status_manager.h"
 #include "updater/updater.h"
+#include "ashmem.h"
 #include "bin_chunk_update.h"
-#include "ring_buffer.h"
+#include "stream_checkpoint.h"
+#include "stream_chunk_pool.h"
+#include "stream_log_sampler.h"
+#include "stream_queue.h"
+#include "stream_update_stats.h"
+#include "sys_installer_common.h"
 #include <atomic>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
 
 namespace OHOS {
 namespace SysInstaller {
+#ifdef UPDATER_UT
+using StreamChunkHandler = std::function<Updater::UpdateResultCode(uint8_t *, uint32_t, uint32_t &)>;
+#endif
 
 class StreamInstallProcesser {
     DISALLOW_COPY_MOVE(StreamInstallProcesser);
@@ -36,24 +49,150 @@ public:
 
     bool IsRunning();
     int32_t Start();
+    // continues a stopped session at its last checkpoint while its parser is still alive, otherwise starts over.
+    // offset is where the client has to resend from (0 for a fresh start)
+    int32_t Resume(uint64_t &offset);
     void Stop();
     int32_t ProcessStreamData(const uint8_t *buffer, uint32_t size);
+    int32_t SetSharedMemory(const sptr<Ashmem> &ashmem, uint32_t slotSize, uint32_t slotNum);
+    int32_t ProcessSharedStreamData(uint32_t slotIndex, uint32_t size);
+    // never blocks: pushResult is STREAM_PUSH_WOULD_BLOCK when all chunks are in flight, the status manager gets
+    // a credits callback as soon as one is free again. credits is the number of chunks that can be pushed now
+    int32_t TryProcessStreamData(const uint8_t *buffer, uint32_t size, StreamPushResult &pushResult,
+        uint32_t &credits);
+    int32_t TryProcessSharedStreamData(uint32_t slotIndex, uint32_t size, StreamPushResult &pushResult,
+        uint32_t &credits);
+    // split into slot sized chunks, acceptedSize is the prefix that made it into the stream
+    int32_t ProcessStreamDataBatch(const uint8_t *buffer, uint32_t size, uint32_t &acceptedSize);
+    // the batch fills the shared memory from slot 0 on, every slot but the last one is full
+    int32_t ProcessSharedStreamDataBatch(uint32_t size, uint32_t &acceptedSize);
+    void ReleaseSharedMemory();
+    static bool IsValidSessionConfig(uint32_t slotSize, uint32_t slotNum);
+    int32_t SetSessionConfig(uint32_t slotSize, uint32_t slotNum);
+    void GetStats(StreamUpdateStats &stats) const
+    {
+        stats_.GetStats(stats);
+    }
+    uint32_t GetSlotSize() const
+    {
+        return slotSize_;
+    }
+    uint32_t GetSlotNum() const
+    {
+        return slotNum_;
+    }
+    uint64_t GetCommittedOffset() const
+    {
+        return committedOffset_;
+    }
+#ifdef UPDATER_UT
+    // chunks go to handler instead of BinChunkUpdate, e.g. a file backed partition in benchmarks
+    void RegisterChunkHandler(StreamChunkHandler handler)
+    {
+        chunkHandler_ = std::move(handler);
+    }
+    void SetCheckpointPath(const std::string &path)
+    {
+        checkpointJournal_.SetPath(path);
+    }
+    // 0 writes a summary line after every chunk, as if the apply thread were not sampled
+    void SetApplyLogInterval(uint32_t intervalMs)
+    {
+        applyLogSampler_ = StreamLogSampler("stream apply", intervalMs);
+    }
+    // all a service restart leaves behind is the journal
+    void DropSessionState()
+    {
+        binChunkUpdate_.reset();
+        committedOffset_ = 0;
+    }
+#endif
     void UpdateResult(UpdateStatus updateStatus, int dealLen, const std::string &resultMsg);
 
 private:
+    enum class ReportType {
+        STATUS,
+        CREDITS,
+        CHECKPOINT,
+    };
+
+    struct StreamReport {
+        UpdateStatus status = UpdateStatus::UPDATE_STATE_INIT;
+        int dealLen = 0;
+        std::string msg {};
+        ReportType type = ReportType::STATUS;
+        uint32_t credits = 0;
+    };
+
+    // where a chunk is copied from: the caller's buffer, or the registered shared memory when buffer is null
+    struct ChunkSource {
+        const uint8_t *buffer = nullptr;
+        uint32_t offset = 0;
+        uint32_t size = 0;
+    };
+
     StreamInstallProcesser() = default;
     ~StreamInstallProcesser() = default;
+    int32_t StartSession();
+    bool StartThreads();
+    void JoinThread(std::thread *&thread);
     void ThreadExecuteFunc();
+    void ReportThreadFunc();
     void ThreadExitProc();
+    int32_t PushChunk(const ChunkSource &source);
+    int32_t TryPushChunk(const ChunkSource &source, StreamPushResult &pushResult, uint32_t &credits);
+    int32_t SubmitChunk(StreamChunk *chunk, const ChunkSource &source);
+    int32_t CopySharedMemory(StreamChunk *chunk, uint32_t offset, uint32_t size);
+    bool GetSharedSlot(uint32_t slotIndex, uint32_t size, ChunkSource &source);
+    void PostCredits();
+    void PostResult(UpdateStatus updateStatus, int dealLen, const std::string &resultMsg);
+    void CommitChunk(uint32_t len);
+    void PostCheckpoint();
+    void FlushCheckpoint();
+    bool SyncTargetPartitions();
+    void ClearCheckpoint();
 
 private:
-    Updater::RingBuffer ringBuffer_;
-    
+    // pipeline: IPC thread -> chunkPool_ -> apply thread -> reportQueue_ -> report thread
+    StreamChunkPool chunkPool_;
+    StreamQueue<StreamReport> reportQueue_ {};
+
+    // binder may deliver consecutive calls on different threads, the pool only allows one producer at a time
+    std::mutex pushLock_;
     std::shared_ptr<StreamStatusManager> statusManager_ {};
     std::shared_ptr<Updater::BinChunkUpdate> binChunkUpdate_ {};
     std::atomic<bool> isExitThread_ = false;
+    // a TryProcessStreamData caller was told to wait and expects a credits callback
+    std::atomic<bool> isCreditWaiting_ = false;
     std::thread *pComsumeThread_ { nullptr };
-    bool isRunning_ = false;
+    std::thread *pReportThread_ { nullptr };
+    std::atomic<bool> isRunning_ = false;
+    std::atomic<uint64_t> committedOffset_ = 0;
+    uint64_t checkpointOffset_ = 0;
+    bool isResumable_ = false;
+    // written by the report thread, only the newest pending checkpoint matters
+    std::mutex checkpointLock_;
+    StreamCheckpoint pendingCheckpoint_ {};
+    bool hasPendingCheckpoint_ = false;
+    // bumped by ClearCheckpoint, a checkpoint taken before must not be written after it
+    uint64_t checkpointGeneration_ = 0;
+    // held while the journal file is written or removed, never while partitions are synced
+    std::mutex journalLock_;
+    StreamCheckpointJournal checkpointJournal_ {};
+    std::string partitionSuffix_ {};
+    StreamUpdateStatsCollector stats_ {};
+    StreamLogSampler applyLogSampler_ {"stream apply"};
+    // set by SetSessionConfig between sessions, read by binder threads pushing data
+    std::atomic<uint32_t> slotSize_ = STREAM_DEFAULT_SLOT_SIZE;
+    std::atomic<uint32_t> slotNum_ = STREAM_DEFAULT_SLOT_NUM;
+#ifdef UPDATER_UT
+    StreamChunkHandler chunkHandler_ {};
+#endif
+
+    std::mutex shmLock_;
+    sptr<Ashmem> shm_ {};
+    uint32_t shmSlotSize_ = 0;
+    uint32_t shmSlotNum_ = 0;
 };
 } // SysInstaller
 } // namespace OHOS
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SYS_INSTALLER_STREAM_UPDATE_STATS_H
+#define SYS_INSTALLER_STREAM_UPDATE_STATS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include "isys_installer.h"
+#include "macros_updater.h"
+
+namespace OHOS {
+namespace SysInstaller {
+// upper bounds of the apply latency buckets in microseconds, the last bucket takes everything above
+constexpr std::array<uint32_t, 11> STREAM_LATENCY_BUCKET_BOUNDS_US = {
+    1000, 2000, 4000, 8000, 16000, 32000, 64000, 128000, 256000, 512000, 1024000
+};
+constexpr size_t STREAM_LATENCY_BUCKET_NUM = STREAM_LATENCY_BUCKET_BOUNDS_US.size() + 1;
+
+// Per-session counters of the stream pipeline, written lock free from the pipeline threads.
+class StreamUpdateStatsCollector {
+    DISALLOW_COPY_MOVE(StreamUpdateStatsCollector);
+public:
+    using Clock = std::chrono::steady_clock;
+
+    StreamUpdateStatsCollector() = default;
+    ~StreamUpdateStatsCollector() = default;
+
+    static uint64_t ElapsedUs(Clock::time_point start)
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            Clock::now() - start).count());
+    }
+    static uint64_t NowUs()
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            Clock::now().time_since_epoch()).count());
+    }
+
+    void Reset();
+    void AddReceived(uint64_t bytes)
+    {
+        bytesReceived_.fetch_add(bytes, std::memory_order_relaxed);
+    }
+    void AddProducerBlocked(uint64_t us)
+    {
+        producerBlockedUs_.fetch_add(us, std::memory_order_relaxed);
+    }
+    void AddConsumerIdle(uint64_t us)
+    {
+        consumerIdleUs_.fetch_add(us, std::memory_order_relaxed);
+    }
+    void RecordApply(uint64_t bytes, uint64_t latencyUs);
+    void GetStats(StreamUpdateStats &stats) const;
+
+private:
+    std::atomic<uint64_t> startUs_ {NowUs()};
+    std::atomic<uint64_t> bytesReceived_ {0};
+    std::atomic<uint64_t> bytesWritten_ {0};
+    std::atomic<uint64_t> chunksWritten_ {0};
+    std::atomic<uint64_t> producerBlockedUs_ {0};
+    std::atomic<uint64_t> consumerIdleUs_ {0};
+    std::array<std::atomic<uint64_t>, STREAM_LATENCY_BUCKET_NUM> latencyHistogram_ {};
+};
+} // SysInstaller
+} // namespace OHOS
+#endif // SYS_INSTALLER_STREAM_UPDATE_STATS_H
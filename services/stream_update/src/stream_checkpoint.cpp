@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "stream_checkpoint.h"
+
+#include <cerrno>
+#include <cstddef>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "log/log.h"
+#include "securec.h"
+
+namespace OHOS {
+namespace SysInstaller {
+using namespace Updater;
+
+namespace {
+constexpr uint32_t CHECKPOINT_MAGIC = 0x53434b50; // "SCKP"
+constexpr uint32_t CHECKPOINT_VERSION = 3;
+constexpr uint32_t FNV_OFFSET_BASIS = 2166136261U;
+constexpr uint32_t FNV_PRIME = 16777619U;
+
+// fixed width fields only, padding is zeroed before the checksum
+struct CheckpointRecord {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t committedOffset;
+    uint32_t slotSize;
+    uint32_t checksum;
+};
+
+uint32_t RecordChecksum(const CheckpointRecord &record)
+{
+    const uint8_t *data = reinterpret_cast<const uint8_t *>(&record);
+    uint32_t hash = FNV_OFFSET_BASIS;
+    for (size_t i = 0; i < offsetof(CheckpointRecord, checksum); i++) {
+        hash = (hash ^ data[i]) * FNV_PRIME;
+    }
+    return hash;
+}
+
+bool WriteAll(int fd, const uint8_t *data, size_t len)
+{
+    while (len > 0) {
+        ssize_t ret = write(fd, data, len);
+        if (ret < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ret <= 0) {
+            return false;
+        }
+        data += ret;
+        len -= static_cast<size_t>(ret);
+    }
+    return true;
+}
+}
+
+bool SyncSlotPartitions(const std::string &dir, const std::string &suffix)
+{
+    if (suffix.empty()) {
+        LOG(ERROR) << "no slot suffix, partitions to sync unknown";
+        return false;
+    }
+    DIR *partitionDir = opendir(dir.c_str());
+    if (partitionDir == nullptr) {
+        LOG(ERROR) << "opendir " << dir << " failed, errno " << errno;
+        return false;
+    }
+    bool ret = true;
+    struct dirent *entry = nullptr;
+    while ((entry = readdir(partitionDir)) != nullptr) {
+        std::string name = entry->d_name;
+        if (name.size() <= suffix.size() || name.compare(name.size() - suffix.size(), suffix.size(), suffix) != 0) {
+            continue;
+        }
+        // flushes the page cache of the block device, whichever fd wrote to it
+        std::string path = dir + "/" + name;
+        int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0 || fdatasync(fd) != 0) {
+            LOG(ERROR) << "sync " << path << " failed, errno " << errno;
+            ret = false;
+        }
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+    closedir(partitionDir);
+    return ret;
+}
+
+bool StreamCheckpointJournal::Save(const StreamCheckpoint &checkpoint)
+{
+    CheckpointRecord record;
+    // padding bytes are part of the checksum, keep them deterministic
+    (void)memset_s(&record, sizeof(record), 0, sizeof(record));
+    record.magic = CHECKPOINT_MAGIC;
+    record.version = CHECKPOINT_VERSION;
+    record.committedOffset = checkpoint.committedOffset;
+    record.slotSize = checkpoint.slotSize;
+    record.checksum = RecordChecksum(record);
+
+    std::string tmpPath = path_ + ".tmp";
+    int fd = open(tmpPath.c_str(), O_CREAT | O_TRUNC | O_WRONLY | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (fd < 0) {
+        LOG(ERROR) << "open " << tmpPath << " failed, errno " << errno;
+        return false;
+    }
+    bool ret = WriteAll(fd, reinterpret_cast<const uint8_t *>(&record), sizeof(record)) && fsync(fd) == 0;
+    close(fd);
+    if (!ret) {
+        LOG(ERROR) << "write " << tmpPath << " failed, errno " << errno;
+        (void)unlink(tmpPath.c_str());
+        return false;
+    }
+    if (rename(tmpPath.c_str(), path_.c_str()) != 0) {
+        LOG(ERROR) << "rename " << tmpPath << " failed, errno " << errno;
+        (void)unlink(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool StreamCheckpointJournal::Load(StreamCheckpoint &checkpoint) const
+{
+    int fd = open(path_.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        LOG(INFO) << "no stream checkpoint at " << path_;
+        return false;
+    }
+    CheckpointRecord record;
+    ssize_t len = read(fd, &record, sizeof(record));
+    close(fd);
+    if (len != static_cast<ssize_t>(sizeof(record)) || record.magic != CHECKPOINT_MAGIC ||
+        record.version != CHECKPOINT_VERSION || record.checksum != RecordChecksum(record)) {
+        LOG(ERROR) << "stream checkpoint " << path_ << " is corrupted";
+        return false;
+    }
+    checkpoint.committedOffset = record.committedOffset;
+    checkpoint.slotSize = record.slotSize;
+    return true;
+}
+
+void StreamCheckpointJournal::Clear()
+{
+    if (unlink(path_.c_str()) != 0 && errno != ENOENT) {
+        LOG(WARNING) << "remove " << path_ << " failed, errno " << errno;
+    }
+}
+} // namespace SysInstaller
+} // namespace OHOS
@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "stream_chunk_pool.h"
+
+#include <cstdlib>
+#include <unistd.h>
+#include "log/log.h"
+
+namespace OHOS {
+namespace SysInstaller {
+using namespace Updater;
+
+namespace {
+constexpr size_t DEFAULT_PAGE_SIZE = 4096;
+
+size_t GetPageSize()
+{
+    long pageSize = sysconf(_SC_PAGESIZE);
+    return pageSize > 0 ? static_cast<size_t>(pageSize) : DEFAULT_PAGE_SIZE;
+}
+}
+
+StreamChunkPool::~StreamChunkPool()
+{
+    FreeMemory();
+}
+
+bool StreamChunkPool::Init(uint32_t chunkSize, uint32_t chunkNum)
+{
+    if (chunkSize == 0 || chunkNum == 0) {
+        LOG(ERROR) << "invalid chunk size " << chunkSize << " or num " << chunkNum;
+        return false;
+    }
+    // keep the buffers of the previous session when the geometry did not change
+    if (memory_ == nullptr || chunkSize != chunkSize_ || chunkNum != chunkNum_) {
+        FreeMemory();
+        size_t pageSize = GetPageSize();
+        size_t stride = (static_cast<size_t>(chunkSize) + pageSize - 1) / pageSize * pageSize;
+        void *memory = nullptr;
+        if (posix_memalign(&memory, pageSize, stride * chunkNum) != 0 || memory == nullptr) {
+            LOG(ERROR) << "alloc chunk pool failed, size " << stride * chunkNum;
+            return false;
+        }
+        memory_ = static_cast<uint8_t *>(memory);
+        chunkSize_ = chunkSize;
+        chunkNum_ = chunkNum;
+        chunks_.assign(chunkNum, StreamChunk {});
+        for (uint32_t i = 0; i < chunkNum; i++) {
+            chunks_[i].data = memory_ + stride * i;
+            chunks_[i].capacity = chunkSize;
+        }
+    }
+    spareChunk_ = nullptr;
+    freeQueue_.Init(chunkNum);
+    readyQueue_.Init(chunkNum);
+    for (auto &chunk : chunks_) {
+        chunk.len = 0;
+        (void)freeQueue_.Push(&chunk);
+    }
+    return true;
+}
+
+void StreamChunkPool::Stop()
+{
+    freeQueue_.Stop();
+    readyQueue_.Stop();
+}
+
+void StreamChunkPool::Reset()
+{
+    // memory stays mapped, a producer may still be copying into a chunk it acquired before Stop
+    spareChunk_ = nullptr;
+    freeQueue_.Clear();
+    readyQueue_.Clear();
+}
+
+StreamChunk *StreamChunkPool::Acquire()
+{
+    StreamChunk *chunk = spareChunk_;
+    spareChunk_ = nullptr;
+    if (chunk == nullptr && !freeQueue_.Pop(chunk)) {
+        return nullptr;
+    }
+    chunk->len = 0;
+    return chunk;
+}
+
+StreamChunk *StreamChunkPool::TryAcquire()
+{
+    StreamChunk *chunk = spareChunk_;
+    spareChunk_ = nullptr;
+    if (chunk == nullptr && !freeQueue_.TryPop(chunk)) {
+        return nullptr;
+    }
+    chunk->len = 0;
+    return chunk;
+}
+
+void StreamChunkPool::Cancel(StreamChunk *chunk)
+{
+    spareChunk_ = chunk;
+}
+
+void StreamChunkPool::Submit(StreamChunk *chunk)
+{
+    if (chunk != nullptr) {
+        (void)readyQueue_.Push(chunk);
+    }
+}
+
+StreamChunk *StreamChunkPool::Pop()
+{
+    StreamChunk *chunk = nullptr;
+    return readyQueue_.Pop(chunk) ? chunk : nullptr;
+}
+
+void StreamChunkPool::Release(StreamChunk *chunk)
+{
+    if (chunk != nullptr) {
+        (void)freeQueue_.Push(chunk);
+    }
+}
+
+void StreamChunkPool::FreeMemory()
+{
+    free(memory_);
+    memory_ = nullptr;
+    chunkSize_ = 0;
+    chunkNum_ = 0;
+    chunks_.clear();
+    spareChunk_ = nullptr;
+    freeQueue_.Clear();
+    readyQueue_.Clear();
+}
+} // namespace SysInstaller
+} // namespace OHOS
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "stream_log_sampler.h"
+
+#include "log/log.h"
+
+namespace OHOS {
+namespace SysInstaller {
+using namespace Updater;
+
+namespace {
+constexpr double BYTES_PER_MB = 1024.0 * 1024.0;
+}
+
+void StreamLogSampler::Reset()
+{
+    sessionStart_ = Clock::now();
+    windowStart_ = sessionStart_;
+    windowChunks_ = 0;
+    windowBytes_ = 0;
+    totalChunks_ = 0;
+    totalBytes_ = 0;
+}
+
+void StreamLogSampler::Flush()
+{
+    Report(Clock::now(), true);
+}
+
+void StreamLogSampler::Report(Clock::time_point now, bool isFinal)
+{
+    totalChunks_ += windowChunks_;
+    totalBytes_ += windowBytes_;
+    Clock::time_point from = isFinal ? sessionStart_ : windowStart_;
+    uint64_t chunks = isFinal ? totalChunks_ : windowChunks_;
+    uint64_t bytes = isFinal ? totalBytes_ : windowBytes_;
+    double seconds = std::chrono::duration<double>(now - from).count();
+    double chunksPerSec = seconds > 0 ? chunks / seconds : 0;
+    double mbPerSec = seconds > 0 ? bytes / BYTES_PER_MB / seconds : 0;
+    LOG(INFO) << tag_ << (isFinal ? " total: " : ": ") << chunks << " chunks " << bytes / BYTES_PER_MB <<
+        " MB in " << seconds << "s, " << chunksPerSec << " chunks/s, " << mbPerSec << " MB/s";
+    windowStart_ = now;
+    windowChunks_ = 0;
+    windowBytes_ = 0;
+}
+} // namespace SysInstaller
+} // namespace OHOS
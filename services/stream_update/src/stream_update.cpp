@@ -22,6 +22,7 @@
 #include "securec.h"
 #include "updater/updater_const.h"
 #include "utils.h"
+#include <algorithm>
 #include <thread>
 #include "updater/updater.h"
 #include "slot_info/slot_info.h"
@@ -30,9 +31,9 @@ namespace OHOS {
 namespace SysInstaller {
 using namespace Updater;
 
-constexpr uint32_t BUFFER_SIZE = 50 * 1024;
-constexpr uint16_t MAX_RING_BUFFER_NUM = 2;
-constexpr uint32_t MAX_UPDATER_BUFFER_SIZE = 2 * BUFFER_SIZE;
+// BinChunkUpdate keeps up to two slots of unparsed data
+constexpr uint32_t UPDATER_BUFFER_SLOT_NUM = 2;
+constexpr size_t REPORT_QUEUE_SIZE = 64;
 
 StreamInstallProcesser &StreamInstallProcesser::GetInstance()
 {
@@ -43,30 +44,96 @@ StreamInstallProcesser &StreamInstallProcesser::GetInstance()
 int32_t StreamInstallProcesser::Start()
 {
     LOG(INFO) << "StreamInstallProcesser Start";
+    ClearCheckpoint();
+    committedOffset_ = 0;
+    checkpointOffset_ = 0;
+    binChunkUpdate_ = std::make_unique<Updater::BinChunkUpdate>(UPDATER_BUFFER_SLOT_NUM * slotSize_);
+    return StartSession();
+}
 
+int32_t StreamInstallProcesser::Resume(uint64_t &offset)
+{
+    LOG(INFO) << "StreamInstallProcesser Resume";
+    offset = 0;
+    StreamCheckpoint checkpoint;
+    if (!checkpointJournal_.Load(checkpoint)) {
+        return Start();
+    }
+    // the parser state only lives in memory, so only the parser that stopped right at the checkpoint can go on,
+    // e.g. after StopStreamUpdate. after a service restart there is none and the stream starts over
+    if (binChunkUpdate_ == nullptr || checkpoint.committedOffset != committedOffset_ ||
+        checkpoint.slotSize != slotSize_) {
+        LOG(WARNING) << "stream checkpoint at " << checkpoint.committedOffset << " can not be resumed, restart";
+        return Start();
+    }
+    checkpointOffset_ = checkpoint.committedOffset;
+    if (StartSession() != 0) {
+        return -1;
+    }
+    offset = checkpoint.committedOffset;
+    LOG(INFO) << "StreamInstallProcesser resume from " << offset;
+    return 0;
+}
+
+int32_t StreamInstallProcesser::StartSession()
+{
     // 处理头部数据的时候设置参数，用于ab流式升级
     if (SetUpdateSuffixParam() != UPDATE_SUCCESS) {
         LOG(ERROR) << "SetUpdateSuffixParam failed";
         return -1;
     }
+    // the stream only writes partitions of the slot being updated, checkpoints flush just those
+    partitionSuffix_.clear();
+    GetPartitionSuffix(partitionSuffix_);
 
-    if (!ringBuffer_.Init(BUFFER_SIZE, MAX_RING_BUFFER_NUM)) {
-        LOG(ERROR) << "StreamInstallProcesser Start Init ringBuffer_ failed";
-        return -1;
+    {
+        std::lock_guard<std::mutex> lock(pushLock_);
+        if (!chunkPool_.Init(slotSize_, slotNum_)) {
+            LOG(ERROR) << "StreamInstallProcesser Start Init chunkPool_ failed";
+            return -1;
+        }
     }
+    reportQueue_.Init(REPORT_QUEUE_SIZE);
+    stats_.Reset();
+    applyLogSampler_.Reset();
+    LOG(INFO) << "StreamInstallProcesser slotSize: " << slotSize_ << " slotNum: " << slotNum_;
 
-    binChunkUpdate_ = std::make_unique<Updater::BinChunkUpdate>(MAX_UPDATER_BUFFER_SIZE);
+    isResumable_ = true;
     isExitThread_ = false;
     isRunning_ = true;
-    pComsumeThread_ = new (std::nothrow) std::thread([this] { this->ThreadExecuteFunc(); });
-    if (pComsumeThread_ == nullptr) {
-        LOG(ERROR) << "StreamInstallProcesser Start new pComsumeThread_ failed";
+    if (!StartThreads()) {
+        LOG(ERROR) << "StreamInstallProcesser Start threads failed";
+        Stop();
         return -1;
     }
     UpdateResult(UpdateStatus::UPDATE_STATE_INIT, 0, "");
     return 0;
 }
 
+bool StreamInstallProcesser::StartThreads()
+{
+    pReportThread_ = new (std::nothrow) std::thread([this] { this->ReportThreadFunc(); });
+    if (pReportThread_ == nullptr) {
+        LOG(ERROR) << "StreamInstallProcesser Start new pReportThread_ failed";
+        return false;
+    }
+    pComsumeThread_ = new (std::nothrow) std::thread([this] { this->ThreadExecuteFunc(); });
+    if (pComsumeThread_ == nullptr) {
+        LOG(ERROR) << "StreamInstallProcesser Start new pComsumeThread_ failed";
+        return false;
+    }
+    return true;
+}
+
+void StreamInstallProcesser::JoinThread(std::thread *&thread)
+{
+    if (thread != nullptr) {
+        thread->join();
+        delete thread;
+        thread = nullptr;
+    }
+}
+
 void StreamInstallProcesser::Stop()
 {
     LOG(INFO) << "StreamInstallProcesser Stop enter";
@@ -77,12 +144,14 @@ void StreamInstallProcesser::Stop()
 
     isRunning_ = false;
     isExitThread_ = true;
-    ringBuffer_.Stop();
-    if (pComsumeThread_ != nullptr) {
-        pComsumeThread_->join();
-        delete pComsumeThread_;
-        pComsumeThread_ = nullptr;
+    chunkPool_.Stop();
+    JoinThread(pComsumeThread_);
+    if (isResumable_) {
+        PostCheckpoint();
     }
+    // results and the last checkpoint are still handled before the report thread exits
+    reportQueue_.Close();
+    JoinThread(pReportThread_);
     ThreadExitProc();
     LOG(INFO) << "StreamInstallProcesser Stop leave";
     return;
@@ -97,27 +166,173 @@ void StreamInstallProcesser::ThreadExecuteFunc()
 {
     LOG(INFO) << "StreamInstallProcesser ThreadExecuteFunc enter";
     while (!isExitThread_) {
-        uint8_t buffer[BUFFER_SIZE]{0};
-        uint32_t len = 0;
+        auto idleStart = StreamUpdateStatsCollector::Clock::now();
+        StreamChunk *chunk = chunkPool_.Pop();
+        if (chunk == nullptr) break;
+        stats_.AddConsumerIdle(StreamUpdateStatsCollector::ElapsedUs(idleStart));
+        uint32_t len = chunk->len;
         uint32_t dealLen = 0;
-        if (!ringBuffer_.Pop(buffer, sizeof(buffer), len)) break;
-        LOG(INFO) << "start bun chunk update ,len = " << len;
-        UpdateResultCode ret = binChunkUpdate_->StartBinChunkUpdate(buffer, len, dealLen);
+        auto applyStart = StreamUpdateStatsCollector::Clock::now();
+#ifdef UPDATER_UT
+        UpdateResultCode ret = chunkHandler_ != nullptr ? chunkHandler_(chunk->data, len, dealLen) :
+            binChunkUpdate_->StartBinChunkUpdate(chunk->data, len, dealLen);
+#else
+        UpdateResultCode ret = binChunkUpdate_->StartBinChunkUpdate(chunk->data, len, dealLen);
+#endif
+        uint64_t applyUs = StreamUpdateStatsCollector::ElapsedUs(applyStart);
+        chunkPool_.Release(chunk);
+        if (isCreditWaiting_.exchange(false)) {
+            PostCredits();
+        }
+        if (ret != STREAM_UPDATE_FAILURE) {
+            stats_.RecordApply(len, applyUs);
+        }
         if (STREAM_UPDATE_SUCCESS == ret) {
-            LOG(INFO) << "StreamInstallProcesser ThreadExecuteFunc STREM_UPDATE_SUCCESS";
-            UpdateResult(UpdateStatus::UPDATE_STATE_ONGOING, dealLen, "");
+            CommitChunk(len);
+            // one summary line per interval instead of two lines per chunk
+            (void)applyLogSampler_.OnChunk(len);
+            PostResult(UpdateStatus::UPDATE_STATE_ONGOING, dealLen, "");
         } else if (STREAM_UPDATE_FAILURE == ret) {
             LOG(ERROR) << "StreamInstallProcesser ThreadExecuteFunc STREM_UPDATE_FAILURE";
-            UpdateResult(UpdateStatus::UPDATE_STATE_FAILED, dealLen, "");
+            isResumable_ = false;
+            ClearCheckpoint();
+            PostResult(UpdateStatus::UPDATE_STATE_FAILED, dealLen, "");
             break;
         } else if (STREAM_UPDATE_COMPLETE == ret) {
             LOG(INFO) << "StreamInstallProcesser ThreadExecuteFunc STREM_UPDATE_COMPLETE";
-            UpdateResult(UpdateStatus::UPDATE_STATE_SUCCESSFUL, dealLen, "");
+            isResumable_ = false;
+            ClearCheckpoint();
+            PostResult(UpdateStatus::UPDATE_STATE_SUCCESSFUL, dealLen, "");
             // 升级完成，切换分区
             SetActiveSlot();
             break;
         }
     }
+    applyLogSampler_.Flush();
+    // nothing consumes chunks any more, do not let the producer block on us
+    chunkPool_.Stop();
+    // a TryProcessStreamData caller still waiting for credits retries and learns that the session is over
+    if (isCreditWaiting_.exchange(false)) {
+        PostCredits();
+    }
+}
+
+void StreamInstallProcesser::CommitChunk(uint32_t len)
+{
+    committedOffset_ += len;
+    if (committedOffset_ - checkpointOffset_ >= STREAM_CHECKPOINT_INTERVAL) {
+        PostCheckpoint();
+    }
+}
+
+void StreamInstallProcesser::PostCheckpoint()
+{
+    // bytes the parser still buffers stay with it, a resume goes on with the same parser
+    StreamCheckpoint checkpoint;
+    checkpoint.committedOffset = committedOffset_;
+    checkpoint.slotSize = slotSize_;
+    checkpointOffset_ = checkpoint.committedOffset;
+    {
+        std::lock_guard<std::mutex> lock(checkpointLock_);
+        pendingCheckpoint_ = checkpoint;
+        hasPendingCheckpoint_ = true;
+    }
+    // the report thread writes it, a slow flush must not stall the writer
+    StreamReport report;
+    report.type = ReportType::CHECKPOINT;
+    if (!reportQueue_.Push(report)) {
+        FlushCheckpoint();
+    }
+}
+
+void StreamInstallProcesser::FlushCheckpoint()
+{
+    StreamCheckpoint checkpoint;
+    uint64_t generation = 0;
+    {
+        std::lock_guard<std::mutex> lock(checkpointLock_);
+        if (!hasPendingCheckpoint_) {
+            // an older doorbell, the newest checkpoint was already written or the journal was cleared
+            return;
+        }
+        hasPendingCheckpoint_ = false;
+        checkpoint = pendingCheckpoint_;
+        generation = checkpointGeneration_;
+    }
+    // the record must not claim data that only sits in the page cache
+    if (!SyncTargetPartitions()) {
+        LOG(ERROR) << "sync stream partitions failed, skip checkpoint at " << checkpoint.committedOffset;
+        return;
+    }
+    std::lock_guard<std::mutex> journalLock(journalLock_);
+    {
+        std::lock_guard<std::mutex> lock(checkpointLock_);
+        if (generation != checkpointGeneration_) {
+            return;
+        }
+    }
+    if (!checkpointJournal_.Save(checkpoint)) {
+        LOG(ERROR) << "save stream checkpoint at " << checkpoint.committedOffset << " failed";
+    }
+}
+
+bool StreamInstallProcesser::SyncTargetPartitions()
+{
+#ifdef UPDATER_UT
+    if (chunkHandler_ != nullptr) {
+        // the handler stands in for the partitions
+        return true;
+    }
+#endif
+    return SyncSlotPartitions(STREAM_PARTITION_DIR, partitionSuffix_);
+}
+
+void StreamInstallProcesser::ClearCheckpoint()
+{
+    {
+        std::lock_guard<std::mutex> lock(checkpointLock_);
+        hasPendingCheckpoint_ = false;
+        checkpointGeneration_++;
+    }
+    // waits for a flush already past the generation check, so its record does not outlive the clear
+    std::lock_guard<std::mutex> journalLock(journalLock_);
+    checkpointJournal_.Clear();
+}
+
+void StreamInstallProcesser::ReportThreadFunc()
+{
+    StreamReport report;
+    while (reportQueue_.Pop(report)) {
+        if (report.type == ReportType::CHECKPOINT) {
+            FlushCheckpoint();
+            continue;
+        }
+        if (report.type == ReportType::CREDITS) {
+            if (statusManager_ != nullptr) {
+                statusManager_->CreditsCallback(report.credits);
+            }
+            continue;
+        }
+        UpdateResult(report.status, report.dealLen, report.msg);
+    }
+}
+
+void StreamInstallProcesser::PostCredits()
+{
+    StreamReport report;
+    report.type = ReportType::CREDITS;
+    report.credits = chunkPool_.GetFreeNum();
+    if (!reportQueue_.Push(report) && statusManager_ != nullptr) {
+        statusManager_->CreditsCallback(report.credits);
+    }
+}
+
+void StreamInstallProcesser::PostResult(UpdateStatus updateStatus, int dealLen, const std::string &resultMsg)
+{
+    // status callbacks are IPC calls to the client, keep them off the write path
+    if (!reportQueue_.Push(StreamReport { updateStatus, dealLen, resultMsg })) {
+        UpdateResult(updateStatus, dealLen, resultMsg);
+    }
 }
 
 void StreamInstallProcesser::ThreadExitProc()
@@ -125,19 +340,272 @@ void StreamInstallProcesser::ThreadExitProc()
     LOG(INFO) << "StreamInstallProcesser ThreadExitProc enter";
     isRunning_ = false;
     isExitThread_ = true;
-    ringBuffer_.Stop();
-    ringBuffer_.Reset();
+    chunkPool_.Stop();
+    {
+        // a producer that got past the stop check may still be submitting, wait for it before resetting
+        std::lock_guard<std::mutex> lock(pushLock_);
+        chunkPool_.Reset();
+    }
 }
 
 int32_t StreamInstallProcesser::ProcessStreamData(const uint8_t *buffer, uint32_t size)
 {
-    uint8_t tmpBuff[BUFFER_SIZE]{0};
-    errno_t ret = memcpy_s(tmpBuff, BUFFER_SIZE, buffer, size);
+    if (buffer == nullptr || size == 0 || size > slotSize_) {
+        LOG(ERROR) << "ProcessStreamData invalid size: " << size;
+        return -1;
+    }
+    return PushChunk(ChunkSource { buffer, 0, size });
+}
+
+int32_t StreamInstallProcesser::TryProcessStreamData(const uint8_t *buffer, uint32_t size,
+    StreamPushResult &pushResult, uint32_t &credits)
+{
+    if (buffer == nullptr || size == 0 || size > slotSize_) {
+        LOG(ERROR) << "TryProcessStreamData invalid size: " << size;
+        return -1;
+    }
+    return TryPushChunk(ChunkSource { buffer, 0, size }, pushResult, credits);
+}
+
+int32_t StreamInstallProcesser::PushChunk(const ChunkSource &source)
+{
+    std::lock_guard<std::mutex> lock(pushLock_);
+    // the pool is only armed between Start and Stop, waiting on it outside a session would never return
+    if (!isRunning_ || isExitThread_) {
+        LOG(ERROR) << "PushChunk stream not running";
+        return -1;
+    }
+    auto blockStart = StreamUpdateStatsCollector::Clock::now();
+    StreamChunk *chunk = chunkPool_.Acquire();
+    stats_.AddProducerBlocked(StreamUpdateStatsCollector::ElapsedUs(blockStart));
+    if (chunk == nullptr) {
+        LOG(ERROR) << "PushChunk chunk pool stopped";
+        return -1;
+    }
+    return SubmitChunk(chunk, source);
+}
+
+int32_t StreamInstallProcesser::TryPushChunk(const ChunkSource &source, StreamPushResult &pushResult,
+    uint32_t &credits)
+{
+    std::lock_guard<std::mutex> lock(pushLock_);
+    pushResult = StreamPushResult::STREAM_PUSH_WOULD_BLOCK;
+    credits = 0;
+    // no credits callback ever follows outside a session, do not tell the caller to wait for one
+    if (!isRunning_ || isExitThread_) {
+        LOG(ERROR) << "TryPushChunk stream not running";
+        return -1;
+    }
+    StreamChunk *chunk = chunkPool_.TryAcquire();
+    if (chunk == nullptr) {
+        isCreditWaiting_ = true;
+        // a chunk released before the flag was set would never be announced, look once more
+        chunk = chunkPool_.TryAcquire();
+        if (chunk == nullptr) {
+            if (chunkPool_.IsStopped()) {
+                LOG(ERROR) << "TryPushChunk chunk pool stopped";
+                return -1;
+            }
+            return 0;
+        }
+        isCreditWaiting_ = false;
+    }
+    if (SubmitChunk(chunk, source) != 0) {
+        return -1;
+    }
+    pushResult = StreamPushResult::STREAM_PUSH_ACCEPTED;
+    credits = chunkPool_.GetFreeNum();
+    return 0;
+}
+
+int32_t StreamInstallProcesser::SubmitChunk(StreamChunk *chunk, const ChunkSource &source)
+{
+    // the only copy on the server side, the chunk itself is handed over to the consumer
+    if (source.buffer == nullptr) {
+        if (CopySharedMemory(chunk, source.offset, source.size) != 0) {
+            chunkPool_.Cancel(chunk);
+            return -1;
+        }
+    } else {
+        errno_t ret = memcpy_s(chunk->data, chunk->capacity, source.buffer, source.size);
+        if (ret != 0) {
+            LOG(ERROR) << "SubmitChunk memcpy_s failed: " << ret;
+            chunkPool_.Cancel(chunk);
+            return -1;
+        }
+    }
+    chunk->len = source.size;
+    chunkPool_.Submit(chunk);
+    stats_.AddReceived(source.size);
+    return 0;
+}
+
+int32_t StreamInstallProcesser::CopySharedMemory(StreamChunk *chunk, uint32_t offset, uint32_t size)
+{
+    // only the copy runs under shmLock_, waiting for a free chunk must not hold up the other shm clients
+    std::lock_guard<std::mutex> lock(shmLock_);
+    if (shm_ == nullptr) {
+        LOG(ERROR) << "CopySharedMemory shared memory not registered";
+        return -1;
+    }
+    const void *data = shm_->ReadFromAshmem(static_cast<int32_t>(size), static_cast<int32_t>(offset));
+    if (data == nullptr) {
+        LOG(ERROR) << "CopySharedMemory ReadFromAshmem failed, offset: " << offset << " size: " << size;
+        return -1;
+    }
+    errno_t ret = memcpy_s(chunk->data, chunk->capacity, data, size);
     if (ret != 0) {
-        LOG(ERROR) << "ProcessStreamData memcpy_s failed: " << ret;
+        LOG(ERROR) << "CopySharedMemory memcpy_s failed: " << ret;
         return -1;
     }
-    return ringBuffer_.Push(tmpBuff, size) ? 0 : -1;
+    return 0;
+}
+
+int32_t StreamInstallProcesser::ProcessStreamDataBatch(const uint8_t *buffer, uint32_t size,
+    uint32_t &acceptedSize)
+{
+    acceptedSize = 0;
+    if (buffer == nullptr || size == 0) {
+        LOG(ERROR) << "ProcessStreamDataBatch invalid size: " << size;
+        return -1;
+    }
+    uint32_t slotSize = slotSize_;
+    while (acceptedSize < size) {
+        uint32_t len = std::min(size - acceptedSize, slotSize);
+        if (PushChunk(ChunkSource { buffer + acceptedSize, 0, len }) != 0) {
+            LOG(ERROR) << "ProcessStreamDataBatch stopped at " << acceptedSize << " of " << size;
+            return -1;
+        }
+        acceptedSize += len;
+    }
+    return 0;
+}
+
+int32_t StreamInstallProcesser::SetSharedMemory(const sptr<Ashmem> &ashmem, uint32_t slotSize, uint32_t slotNum)
+{
+    if (ashmem == nullptr || slotSize == 0 || slotSize > slotSize_ || slotNum == 0) {
+        LOG(ERROR) << "SetSharedMemory invalid param, slotSize: " << slotSize << " slotNum: " << slotNum;
+        return -1;
+    }
+    uint64_t totalSize = static_cast<uint64_t>(slotSize) * slotNum;
+    int32_t ashmemSize = ashmem->GetAshmemSize();
+    if (ashmemSize < 0 || totalSize > static_cast<uint64_t>(ashmemSize)) {
+        LOG(ERROR) << "SetSharedMemory ashmem too small: " << ashmemSize << ", need " << totalSize;
+        return -1;
+    }
+    if (!ashmem->MapReadOnlyAshmem()) {
+        LOG(ERROR) << "SetSharedMemory MapReadOnlyAshmem failed";
+        return -1;
+    }
+
+    std::lock_guard<std::mutex> lock(shmLock_);
+    if (shm_ != nullptr) {
+        shm_->UnmapAshmem();
+        shm_->CloseAshmem();
+    }
+    shm_ = ashmem;
+    shmSlotSize_ = slotSize;
+    shmSlotNum_ = slotNum;
+    LOG(INFO) << "SetSharedMemory slotSize: " << slotSize << " slotNum: " << slotNum;
+    return 0;
+}
+
+bool StreamInstallProcesser::GetSharedSlot(uint32_t slotIndex, uint32_t size, ChunkSource &source)
+{
+    std::lock_guard<std::mutex> lock(shmLock_);
+    if (shm_ == nullptr) {
+        LOG(ERROR) << "GetSharedSlot shared memory not registered";
+        return false;
+    }
+    if (slotIndex >= shmSlotNum_ || size == 0 || size > shmSlotSize_) {
+        LOG(ERROR) << "GetSharedSlot invalid slot: " << slotIndex << " size: " << size;
+        return false;
+    }
+    source = ChunkSource { nullptr, slotIndex * shmSlotSize_, size };
+    return true;
+}
+
+int32_t StreamInstallProcesser::ProcessSharedStreamData(uint32_t slotIndex, uint32_t size)
+{
+    ChunkSource source;
+    if (!GetSharedSlot(slotIndex, size, source)) {
+        return -1;
+    }
+    // copied straight from the mapped slot, the client reuses the slot once this call returns
+    return PushChunk(source);
+}
+
+int32_t StreamInstallProcesser::TryProcessSharedStreamData(uint32_t slotIndex, uint32_t size,
+    StreamPushResult &pushResult, uint32_t &credits)
+{
+    ChunkSource source;
+    if (!GetSharedSlot(slotIndex, size, source)) {
+        return -1;
+    }
+    return TryPushChunk(source, pushResult, credits);
+}
+
+int32_t StreamInstallProcesser::ProcessSharedStreamDataBatch(uint32_t size, uint32_t &acceptedSize)
+{
+    acceptedSize = 0;
+    uint32_t shmSlotSize = 0;
+    {
+        std::lock_guard<std::mutex> lock(shmLock_);
+        if (shm_ == nullptr) {
+            LOG(ERROR) << "ProcessSharedStreamDataBatch shared memory not registered";
+            return -1;
+        }
+        if (size == 0 || static_cast<uint64_t>(size) > static_cast<uint64_t>(shmSlotSize_) * shmSlotNum_) {
+            LOG(ERROR) << "ProcessSharedStreamDataBatch invalid size: " << size;
+            return -1;
+        }
+        shmSlotSize = shmSlotSize_;
+    }
+    while (acceptedSize < size) {
+        uint32_t len = std::min(size - acceptedSize, shmSlotSize);
+        if (PushChunk(ChunkSource { nullptr, acceptedSize, len }) != 0) {
+            LOG(ERROR) << "ProcessSharedStreamDataBatch stopped at " << acceptedSize << " of " << size;
+            return -1;
+        }
+        acceptedSize += len;
+    }
+    return 0;
+}
+
+bool StreamInstallProcesser::IsValidSessionConfig(uint32_t slotSize, uint32_t slotNum)
+{
+    return slotSize >= STREAM_MIN_SLOT_SIZE && slotSize <= STREAM_MAX_SLOT_SIZE &&
+        slotNum >= STREAM_MIN_SLOT_NUM && slotNum <= STREAM_MAX_SLOT_NUM &&
+        static_cast<uint64_t>(slotSize) * slotNum <= STREAM_MAX_RING_SIZE;
+}
+
+int32_t StreamInstallProcesser::SetSessionConfig(uint32_t slotSize, uint32_t slotNum)
+{
+    if (isRunning_) {
+        LOG(ERROR) << "SetSessionConfig not allowed while running";
+        return -1;
+    }
+    if (!IsValidSessionConfig(slotSize, slotNum)) {
+        LOG(ERROR) << "SetSessionConfig invalid slotSize: " << slotSize << " slotNum: " << slotNum;
+        return -1;
+    }
+    slotSize_ = slotSize;
+    slotNum_ = slotNum;
+    LOG(INFO) << "SetSessionConfig slotSize: " << slotSize << " slotNum: " << slotNum;
+    return 0;
+}
+
+void StreamInstallProcesser::ReleaseSharedMemory()
+{
+    std::lock_guard<std::mutex> lock(shmLock_);
+    if (shm_ == nullptr) {
+        return;
+    }
+    shm_->UnmapAshmem();
+    shm_->CloseAshmem();
+    shm_ = nullptr;
+    shmSlotSize_ = 0;
+    shmSlotNum_ = 0;
 }
 
 void StreamInstallProcesser::UpdateResult(UpdateStatus updateStatus, int dealLen, const std::string &resultMsg)
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "stream_update_stats.h"
+
+#include <algorithm>
+
+namespace OHOS {
+namespace SysInstaller {
+void StreamUpdateStatsCollector::Reset()
+{
+    startUs_ = NowUs();
+    bytesReceived_ = 0;
+    bytesWritten_ = 0;
+    chunksWritten_ = 0;
+    producerBlockedUs_ = 0;
+    consumerIdleUs_ = 0;
+    for (auto &bucket : latencyHistogram_) {
+        bucket = 0;
+    }
+}
+
+void StreamUpdateStatsCollector::RecordApply(uint64_t bytes, uint64_t latencyUs)
+{
+    bytesWritten_.fetch_add(bytes, std::memory_order_relaxed);
+    chunksWritten_.fetch_add(1, std::memory_order_relaxed);
+    auto bound = std::lower_bound(STREAM_LATENCY_BUCKET_BOUNDS_US.begin(), STREAM_LATENCY_BUCKET_BOUNDS_US.end(),
+        latencyUs);
+    size_t index = static_cast<size_t>(bound - STREAM_LATENCY_BUCKET_BOUNDS_US.begin());
+    latencyHistogram_[index].fetch_add(1, std::memory_order_relaxed);
+}
+
+void StreamUpdateStatsCollector::GetStats(StreamUpdateStats &stats) const
+{
+    stats.bytesReceived = bytesReceived_.load(std::memory_order_relaxed);
+    stats.bytesWritten = bytesWritten_.load(std::memory_order_relaxed);
+    stats.chunksWritten = chunksWritten_.load(std::memory_order_relaxed);
+    stats.producerBlockedUs = producerBlockedUs_.load(std::memory_order_relaxed);
+    stats.consumerIdleUs = consumerIdleUs_.load(std::memory_order_relaxed);
+    stats.elapsedUs = NowUs() - startUs_.load(std::memory_order_relaxed);
+    stats.latencyBucketBoundsUs.assign(STREAM_LATENCY_BUCKET_BOUNDS_US.begin(), STREAM_LATENCY_BUCKET_BOUNDS_US.end());
+    stats.latencyHistogram.clear();
+    for (const auto &bucket : latencyHistogram_) {
+        stats.latencyHistogram.push_back(bucket.load(std::memory_order_relaxed));
+    }
+}
+} // namespace SysInstaller
+} // namespace OHOS
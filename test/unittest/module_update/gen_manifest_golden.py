@@ -0,0 +1,83 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+# Copyright (c) 2025 Huawei Device Co., Ltd.
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+Runs gen_module_manifest.py on a checked in pack.info and embeds both the
+json and the generated pack.info.bin in a header, so the unittest checks the
+device loader against the real build time writer.
+"""
+
+import os
+import sys
+import zipfile
+import argparse
+import tempfile
+
+# keep the source tree clean of __pycache__
+sys.dont_write_bytecode = True
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                                "../../../tools/module_update_tool"))
+import gen_module_manifest  # noqa: E402
+
+BYTES_PER_LINE = 16
+
+
+def to_array(name, data):
+    lines = ["static const uint8_t %s[] = {" % name]
+    for begin in range(0, len(data), BYTES_PER_LINE):
+        lines.append("    " + ", ".join("0x%02x" % byte for byte in data[begin:begin + BYTES_PER_LINE]) + ",")
+    lines.append("};")
+    return "\n".join(lines)
+
+
+def gen_golden(pack_info_path, output_path):
+    with open(pack_info_path, "rb") as pack_info:
+        content = pack_info.read()
+    with tempfile.TemporaryDirectory() as tmp_dir:
+        zip_path = os.path.join(tmp_dir, "module_info.zip")
+        manifest_path = os.path.join(tmp_dir, "pack.info.bin")
+        with zipfile.ZipFile(zip_path, "w", zipfile.ZIP_DEFLATED) as hmp_zip:
+            hmp_zip.writestr(gen_module_manifest.PACK_INFO_NAME, content)
+        gen_module_manifest.gen_manifest(zip_path, manifest_path)
+        with open(manifest_path, "rb") as manifest_file:
+            manifest = manifest_file.read()
+    header = [
+        "// generated by gen_manifest_golden.py, do not edit",
+        "#ifndef SYS_INSTALLER_MODULE_MANIFEST_GOLDEN_H",
+        "#define SYS_INSTALLER_MODULE_MANIFEST_GOLDEN_H",
+        "",
+        "#include <cstdint>",
+        "",
+        to_array("GOLDEN_PACK_INFO", content),
+        to_array("GOLDEN_MANIFEST", manifest),
+        "#endif // SYS_INSTALLER_MODULE_MANIFEST_GOLDEN_H",
+        "",
+    ]
+    with open(output_path, "w") as output:
+        output.write("\n".join(header))
+
+
+def main(argv):
+    parser = argparse.ArgumentParser()
+    parser.add_argument("-p", "--pack_info", required=True, help="pack.info json to compile")
+    parser.add_argument("-o", "--output", required=True, help="header to write")
+    args = parser.parse_args(argv[1:])
+    gen_golden(args.pack_info, args.output)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
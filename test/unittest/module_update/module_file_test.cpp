@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <string>
+
+#include "gtest/gtest.h"
+#include "module_file.h"
+
+using namespace testing::ext;
+using namespace std;
+
+namespace OHOS {
+namespace SysInstaller {
+class ModuleFileTest : public testing::Test {};
+
+/**
+ * @tc.name: CompareUnorderedLists
+ * @tc.desc: sa and bundle lists built by a caller in any order compare by saId and bundle name
+ * @tc.type: FUNC
+ */
+HWTEST_F(ModuleFileTest, CompareUnorderedLists, TestSize.Level1)
+{
+    ModulePackageInfo oldInfo;
+    oldInfo.version = "test 1.0.0.1";
+    ModuleInfo &oldModule = oldInfo.moduleMap["test"];
+    oldModule.saInfoList.push_back({"sa1", 1, {1, 1, 1}});
+    oldModule.saInfoList.push_back({"sa2", 2, {1, 1, 1}});
+    oldModule.bundleInfoList.push_back({"com.a", "1"});
+    oldModule.bundleInfoList.push_back({"com.b", "1"});
+    ModulePackageInfo newInfo = oldInfo;
+    newInfo.version = "test 1.0.0.2";
+    ModuleInfo &newModule = newInfo.moduleMap.at("test");
+    newModule.saInfoList.reverse();
+    newModule.saInfoList.front().version.patchVersion = 2;
+    newModule.bundleInfoList.reverse();
+    ModuleFile oldFile("/data/module_update_package/test/module_info.zip", oldInfo, std::nullopt);
+    ModuleFile newFile("/data/module_update/active/test/module_info.zip", newInfo, std::nullopt);
+    EXPECT_TRUE(ModuleFile::CompareVersion(newFile, oldFile));
+    EXPECT_FALSE(ModuleFile::CompareVersion(oldFile, newFile));
+}
+
+/**
+ * @tc.name: CopySharesVersionInfo
+ * @tc.desc: copies of a module file share one version info
+ * @tc.type: FUNC
+ */
+HWTEST_F(ModuleFileTest, CopySharesVersionInfo, TestSize.Level1)
+{
+    ModulePackageInfo versionInfo;
+    versionInfo.hmpName = "test";
+    versionInfo.version = "test 1.0.0.1";
+    ModuleFile file("/data/module_update_package/test/module_info.zip", versionInfo, std::nullopt);
+    ModuleFile copy(file);
+    EXPECT_EQ(&copy.GetVersionInfo(), &file.GetVersionInfo());
+    EXPECT_TRUE(copy.GetHmpVersion().valid);
+    ModuleFile moved(std::move(copy));
+    EXPECT_EQ(&moved.GetVersionInfo(), &file.GetVersionInfo());
+    EXPECT_EQ(moved.GetHmpVersion().prefix, "test");
+    EXPECT_EQ(moved.GetHmpVersion().prefix.data(), file.GetVersionInfo().version.data());
+}
+
+/**
+ * @tc.name: HmpVersionParse
+ * @tc.desc: parsed versions keep the numbers and reject malformed strings
+ * @tc.type: FUNC
+ */
+HWTEST_F(ModuleFileTest, HmpVersionParse, TestSize.Level1)
+{
+    HmpVersion version;
+    ASSERT_TRUE(ParseHmpVersion("xxx-d01 4.10.0.1", ' ', version));
+    EXPECT_EQ(version.prefix, "xxx-d01");
+    EXPECT_EQ(version.number[0], 4);
+    EXPECT_EQ(version.number[1], 10);
+    EXPECT_EQ(version.number[2], 0);
+    EXPECT_EQ(version.number[3], 1);
+    EXPECT_FALSE(ParseHmpVersion("xxx-d01 4.10.0", ' ', version));
+    EXPECT_FALSE(ParseHmpVersion("xxx-d01 4.10.0.1.1", ' ', version));
+    EXPECT_FALSE(ParseHmpVersion("xxx-d01 4..0.1", ' ', version));
+    EXPECT_FALSE(ParseHmpVersion("xxx-d01_4.10.0.1", ' ', version));
+    EXPECT_FALSE(version.valid);
+}
+
+/**
+ * @tc.name: HmpVersionPrefix
+ * @tc.desc: versions only compare when their prefixes are equal
+ * @tc.type: FUNC
+ */
+HWTEST_F(ModuleFileTest, HmpVersionPrefix, TestSize.Level1)
+{
+    HmpVersion smallVersion;
+    HmpVersion bigVersion;
+    ASSERT_TRUE(ParseHmpVersion("xxx-d01 4.10.0.1", ' ', smallVersion));
+    ASSERT_TRUE(ParseHmpVersion("xxx-d01 4.10.0.2", ' ', bigVersion));
+    EXPECT_TRUE(CompareHmpVersion(smallVersion, bigVersion));
+    ASSERT_TRUE(ParseHmpVersion("yyy-d01 4.10.0.2", ' ', bigVersion));
+    EXPECT_FALSE(CompareHmpVersion(smallVersion, bigVersion));
+    EXPECT_FALSE(CompareSaSdkVersion(smallVersion, bigVersion));
+    ASSERT_TRUE(ParseHmpVersion("xxx-d0 4.10.0.2", ' ', bigVersion));
+    EXPECT_FALSE(CompareHmpVersion(smallVersion, bigVersion));
+}
+} // namespace SysInstaller
+} // namespace OHOS
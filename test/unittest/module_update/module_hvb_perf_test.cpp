@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <chrono>
+#include <fcntl.h>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "directory_ex.h"
+#include "module_constants.h"
+#include "module_hvb_ops.h"
+#include "module_pack_info_cache.h"
+#include "module_test_zip.h"
+
+using namespace testing::ext;
+using namespace std;
+
+namespace OHOS {
+namespace SysInstaller {
+namespace {
+constexpr const char *BENCH_HMP_DIR = "/data/local/tmp/module_hvb_bench/";
+constexpr const char *BENCH_PACK_INFO = R"({"type":"APP","package":{"name":"bench","version":"bench 1.0.0.1",
+"displayVersion":"1.0.0.1","apiVersion":"10","bundleList":{}}})";
+constexpr uint32_t BENCH_IMAGE_SIZE = 4 * 1024 * 1024;
+constexpr uint32_t EXT4_MAGIC_OFFSET = 1080;
+constexpr uint32_t BENCH_READ_SIZE = 4096;
+constexpr double NS_PER_US = 1000.0;
+
+int64_t NowNs()
+{
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool WriteBenchImage(const string &imagePath)
+{
+    vector<uint8_t> image(BENCH_IMAGE_SIZE, 0);
+    image[EXT4_MAGIC_OFFSET] = 0x53; // ext4 magic 0xEF53, little endian
+    image[EXT4_MAGIC_OFFSET + 1] = 0xEF;
+    int fd = open(imagePath.c_str(), O_CREAT | O_TRUNC | O_WRONLY | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (fd < 0) {
+        return false;
+    }
+    bool ret = write(fd, image.data(), image.size()) == static_cast<ssize_t>(image.size());
+    close(fd);
+    return ret;
+}
+
+// walks the whole image in hvb sized reads, the same pattern footer and hashtree verification issue
+double ReadWholeImage(struct hvb_ops *ops, const string &imagePath, uint64_t &totalRead)
+{
+    vector<uint8_t> buf(BENCH_READ_SIZE);
+    totalRead = 0;
+    int64_t start = NowNs();
+    for (int64_t offset = 0; offset < BENCH_IMAGE_SIZE; offset += BENCH_READ_SIZE) {
+        uint64_t numRead = 0;
+        if (ops->read_partition(ops, imagePath.c_str(), offset, BENCH_READ_SIZE, buf.data(), &numRead) != HVB_IO_OK) {
+            return -1.0;
+        }
+        totalRead += numRead;
+    }
+    return static_cast<double>(NowNs() - start) / NS_PER_US;
+}
+}
+
+class ModuleHvbPerfTest : public testing::Test {
+public:
+    void SetUp() override
+    {
+        ForceCreateDirectory(BENCH_HMP_DIR);
+        ASSERT_TRUE(WriteTestZip(string(BENCH_HMP_DIR) + HMP_INFO_NAME, {{PACK_INFO_NAME, BENCH_PACK_INFO}}));
+        ASSERT_TRUE(WriteBenchImage(string(BENCH_HMP_DIR) + IMG_FILE_NAME));
+    }
+    void TearDown() override
+    {
+        ModulePackInfoCache::GetInstance().Clear();
+        ForceRemoveDirectory(BENCH_HMP_DIR);
+    }
+};
+
+/**
+ * @tc.name: HvbReadPartition
+ * @tc.desc: cost of the hvb read callbacks over one image, shared ops vs per verification context
+ * @tc.type: FUNC
+ */
+HWTEST_F(ModuleHvbPerfTest, HvbReadPartition, TestSize.Level1)
+{
+    string imagePath = string(BENCH_HMP_DIR) + IMG_FILE_NAME;
+    uint64_t sharedRead = 0;
+    double sharedUs = ReadWholeImage(ModuleHvbGetOps(), imagePath, sharedRead);
+    ASSERT_GE(sharedUs, 0.0);
+
+    ModuleHvbContext context;
+    ModuleHvbInitContext(context);
+    uint64_t contextRead = 0;
+    double contextUs = ReadWholeImage(&context.ops, imagePath, contextRead);
+    ASSERT_GE(contextUs, 0.0);
+    EXPECT_EQ(sharedRead, BENCH_IMAGE_SIZE);
+    EXPECT_EQ(contextRead, BENCH_IMAGE_SIZE);
+    EXPECT_EQ(context.partition, imagePath);
+    cout << "hvb read " << BENCH_IMAGE_SIZE / BENCH_READ_SIZE << " x " << BENCH_READ_SIZE << "B: shared ops " <<
+        sharedUs << " us, context " << contextUs << " us" << endl;
+}
+
+/**
+ * @tc.name: HvbReadPartitionTail
+ * @tc.desc: negative offsets are relative to the image end and reads are clamped to the image
+ * @tc.type: FUNC
+ */
+HWTEST_F(ModuleHvbPerfTest, HvbReadPartitionTail, TestSize.Level1)
+{
+    string imagePath = string(BENCH_HMP_DIR) + IMG_FILE_NAME;
+    ModuleHvbContext context;
+    ModuleHvbInitContext(context);
+    vector<uint8_t> buf(BENCH_READ_SIZE);
+    uint64_t numRead = 0;
+    EXPECT_EQ(context.ops.read_partition(&context.ops, imagePath.c_str(), -64, BENCH_READ_SIZE, buf.data(),
+        &numRead), HVB_IO_OK);
+    EXPECT_EQ(numRead, 64u);
+    EXPECT_EQ(context.ops.read_partition(&context.ops, imagePath.c_str(), EXT4_MAGIC_OFFSET, 2, buf.data(),
+        &numRead), HVB_IO_OK);
+    EXPECT_EQ(buf[0], 0x53);
+    EXPECT_EQ(buf[1], 0xEF);
+}
+} // namespace SysInstaller
+} // namespace OHOS
@@ -0,0 +1,226 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "directory_ex.h"
+#include "file_ex.h"
+#include "module_constants.h"
+#include "module_manifest_golden.h"
+#include "module_manifest_writer.h"
+#include "module_pack_info_cache.h"
+#include "module_test_zip.h"
+
+using namespace testing::ext;
+using namespace std;
+
+namespace OHOS {
+namespace SysInstaller {
+namespace {
+constexpr const char *TEST_DIR = "/data/local/tmp/module_manifest_test/";
+constexpr const char *TEST_ZIP_PATH = "/data/local/tmp/module_manifest_test/module_info.zip";
+constexpr const char *TEST_MANIFEST_PATH = "/data/local/tmp/module_manifest_test/pack.info.bin";
+constexpr const char *PACK_INFO_CONTENT = R"({
+    "type": "full",
+    "packageType": "module",
+    "package": {"name": "test_hmp", "version": "1.0.0.1", "laneInfo": {"laneCode": "lane"}}
+})";
+
+bool CreatePackInfoZip(const string &content)
+{
+    return WriteTestZip(TEST_ZIP_PATH, {{PACK_INFO_NAME, content}});
+}
+
+void ExpectSameModules(const ModulePackageInfo &actual, const ModulePackageInfo &expected)
+{
+    ASSERT_EQ(actual.moduleMap.size(), expected.moduleMap.size());
+    for (const auto &[name, expectedModule] : expected.moduleMap) {
+        auto it = actual.moduleMap.find(name);
+        ASSERT_NE(it, actual.moduleMap.end()) << name;
+        const ModuleInfo &module = it->second;
+        ASSERT_EQ(module.saInfoList.size(), expectedModule.saInfoList.size()) << name;
+        auto sa = module.saInfoList.begin();
+        for (const auto &expectedSa : expectedModule.saInfoList) {
+            EXPECT_EQ(sa->saName, expectedSa.saName) << name;
+            EXPECT_EQ(sa->saId, expectedSa.saId) << name;
+            EXPECT_EQ(sa->version.apiVersion, expectedSa.version.apiVersion) << name;
+            EXPECT_EQ(sa->version.versionCode, expectedSa.version.versionCode) << name;
+            EXPECT_EQ(sa->version.patchVersion, expectedSa.version.patchVersion) << name;
+            ++sa;
+        }
+        ASSERT_EQ(module.bundleInfoList.size(), expectedModule.bundleInfoList.size()) << name;
+        auto bundle = module.bundleInfoList.begin();
+        for (const auto &expectedBundle : expectedModule.bundleInfoList) {
+            EXPECT_EQ(bundle->bundleName, expectedBundle.bundleName) << name;
+            EXPECT_EQ(bundle->bundleVersion, expectedBundle.bundleVersion) << name;
+            ++bundle;
+        }
+    }
+}
+
+void ExpectSameMeta(const ModulePackInfoMeta &actual, const ModulePackInfoMeta &expected)
+{
+    EXPECT_EQ(actual.isModuleInfoValid, expected.isModuleInfoValid);
+    EXPECT_EQ(actual.type, expected.type);
+    EXPECT_EQ(actual.packageType, expected.packageType);
+    EXPECT_EQ(actual.imageHash, expected.imageHash);
+    EXPECT_EQ(actual.name, expected.name);
+    EXPECT_EQ(actual.version, expected.version);
+    EXPECT_EQ(actual.apiVersion, expected.apiVersion);
+    EXPECT_EQ(actual.saSdkVersion, expected.saSdkVersion);
+    EXPECT_EQ(actual.compatibleVersion, expected.compatibleVersion);
+    EXPECT_EQ(actual.laneCode, expected.laneCode);
+    const ModulePackageInfo &info = actual.moduleInfo;
+    EXPECT_EQ(info.hmpName, expected.moduleInfo.hmpName);
+    EXPECT_EQ(info.version, expected.moduleInfo.version);
+    EXPECT_EQ(info.displayVersion, expected.moduleInfo.displayVersion);
+    EXPECT_EQ(info.saSdkVersion, expected.moduleInfo.saSdkVersion);
+    EXPECT_EQ(info.type, expected.moduleInfo.type);
+    EXPECT_EQ(info.apiVersion, expected.moduleInfo.apiVersion);
+    ExpectSameModules(info, expected.moduleInfo);
+}
+}
+
+class ModuleManifestTest : public testing::Test {
+public:
+    void SetUp() override
+    {
+        ForceCreateDirectory(TEST_DIR);
+        ASSERT_TRUE(CreatePackInfoZip(PACK_INFO_CONTENT));
+    }
+    void TearDown() override
+    {
+        ModulePackInfoCache::GetInstance().Clear();
+        ForceRemoveDirectory(TEST_DIR);
+    }
+};
+
+/**
+ * @tc.name: RoundTrip
+ * @tc.desc: a generated manifest loads back to the same meta as the json
+ * @tc.type: FUNC
+ */
+HWTEST_F(ModuleManifestTest, RoundTrip, TestSize.Level1)
+{
+    ASSERT_TRUE(GenerateModuleManifest(TEST_ZIP_PATH));
+    ModuleZipHelper helper(TEST_ZIP_PATH);
+    ASSERT_TRUE(helper.IsValid());
+    const ModuleZipEntry *entry = helper.FindEntry(PACK_INFO_NAME);
+    ASSERT_NE(entry, nullptr);
+    ModulePackInfoMeta meta;
+    ASSERT_TRUE(LoadModuleManifest(TEST_MANIFEST_PATH, *entry, meta));
+    ExpectSameMeta(meta, *ParsePackInfoMeta(PACK_INFO_CONTENT));
+}
+
+/**
+ * @tc.name: BuildToolManifest
+ * @tc.desc: pack.info.bin written by gen_module_manifest.py loads to the same meta as the json
+ * @tc.type: FUNC
+ */
+HWTEST_F(ModuleManifestTest, BuildToolManifest, TestSize.Level1)
+{
+    string packInfo(reinterpret_cast<const char *>(GOLDEN_PACK_INFO), sizeof(GOLDEN_PACK_INFO));
+    ASSERT_TRUE(CreatePackInfoZip(packInfo));
+    string manifest(reinterpret_cast<const char *>(GOLDEN_MANIFEST), sizeof(GOLDEN_MANIFEST));
+    ASSERT_TRUE(SaveStringToFile(TEST_MANIFEST_PATH, manifest));
+    ModuleZipHelper helper(TEST_ZIP_PATH);
+    ASSERT_TRUE(helper.IsValid());
+    const ModuleZipEntry *entry = helper.FindEntry(PACK_INFO_NAME);
+    ASSERT_NE(entry, nullptr);
+    ModulePackInfoMeta meta;
+    ASSERT_TRUE(LoadModuleManifest(TEST_MANIFEST_PATH, *entry, meta));
+    auto json = ParsePackInfoMeta(packInfo);
+    ASSERT_TRUE(json->isModuleInfoValid);
+    EXPECT_EQ(json->moduleInfo.moduleMap.size(), 2u);
+    ExpectSameMeta(meta, *json);
+}
+
+/**
+ * @tc.name: StaleManifest
+ * @tc.desc: a manifest of an older pack.info is rejected
+ * @tc.type: FUNC
+ */
+HWTEST_F(ModuleManifestTest, StaleManifest, TestSize.Level1)
+{
+    ASSERT_TRUE(GenerateModuleManifest(TEST_ZIP_PATH));
+    ASSERT_TRUE(CreatePackInfoZip(R"({"type": "diff"})"));
+    ModuleZipHelper helper(TEST_ZIP_PATH);
+    ASSERT_TRUE(helper.IsValid());
+    const ModuleZipEntry *entry = helper.FindEntry(PACK_INFO_NAME);
+    ASSERT_NE(entry, nullptr);
+    ModulePackInfoMeta meta;
+    EXPECT_FALSE(LoadModuleManifest(TEST_MANIFEST_PATH, *entry, meta));
+    ModulePackInfoCache::GetInstance().Clear();
+    auto cached = ModulePackInfoCache::GetInstance().Get(TEST_ZIP_PATH);
+    ASSERT_NE(cached, nullptr);
+    EXPECT_EQ(cached->type, "diff");
+}
+
+/**
+ * @tc.name: ForgedManifestIgnored
+ * @tc.desc: a manifest on a writable partition is not trusted even when its crc matches
+ * @tc.type: FUNC
+ */
+HWTEST_F(ModuleManifestTest, ForgedManifestIgnored, TestSize.Level1)
+{
+    ModuleZipHelper helper(TEST_ZIP_PATH);
+    ASSERT_TRUE(helper.IsValid());
+    const ModuleZipEntry *entry = helper.FindEntry(PACK_INFO_NAME);
+    ASSERT_NE(entry, nullptr);
+    ModulePackInfoMeta forged;
+    forged.type = "diff";
+    ASSERT_TRUE(SaveModuleManifest(TEST_MANIFEST_PATH, *entry, forged));
+    ModulePackInfoMeta meta;
+    ASSERT_TRUE(LoadModuleManifest(TEST_MANIFEST_PATH, *entry, meta));
+    EXPECT_EQ(meta.type, "diff");
+    EXPECT_FALSE(LoadTrustedModuleManifest(TEST_ZIP_PATH, *entry, meta));
+    auto cached = ModulePackInfoCache::GetInstance().Get(TEST_ZIP_PATH);
+    ASSERT_NE(cached, nullptr);
+    EXPECT_EQ(cached->type, "full");
+}
+
+/**
+ * @tc.name: CacheReplacedPackage
+ * @tc.desc: concurrent lookups share one parse, a replaced package is parsed again
+ * @tc.type: FUNC
+ */
+HWTEST_F(ModuleManifestTest, CacheReplacedPackage, TestSize.Level1)
+{
+    constexpr size_t threadNum = 4;
+    auto &cache = ModulePackInfoCache::GetInstance();
+    vector<shared_ptr<const ModulePackInfoMeta>> metas(threadNum);
+    vector<thread> threads;
+    for (size_t i = 0; i < threadNum; i++) {
+        threads.emplace_back([&metas, &cache, i] { metas[i] = cache.Get(TEST_ZIP_PATH); });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+    ASSERT_NE(metas[0], nullptr);
+    for (const auto &meta : metas) {
+        EXPECT_EQ(meta, metas[0]);
+    }
+    EXPECT_EQ(metas[0]->type, "full");
+
+    ASSERT_TRUE(CreatePackInfoZip(R"({"type": "diff"})"));
+    auto replaced = cache.Get(TEST_ZIP_PATH);
+    ASSERT_NE(replaced, nullptr);
+    EXPECT_EQ(replaced->type, "diff");
+    EXPECT_EQ(cache.Get(TEST_ZIP_PATH), replaced);
+}
+} // namespace SysInstaller
+} // namespace OHOS
@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "module_manifest_writer.h"
+
+#include <optional>
+#include <vector>
+
+#include "directory_ex.h"
+#include "file_ex.h"
+#include "module_constants.h"
+
+namespace OHOS {
+namespace SysInstaller {
+namespace {
+constexpr uint32_t FNV_OFFSET_BASIS = 2166136261U;
+constexpr uint32_t FNV_PRIME = 16777619U;
+constexpr uint32_t MANIFEST_ALIGN = 4;
+
+uint32_t Fnv1a(const uint8_t *data, size_t size)
+{
+    uint32_t hash = FNV_OFFSET_BASIS;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= data[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+class ManifestWriter {
+public:
+    ModuleManifestStr AddString(const std::optional<std::string> &str)
+    {
+        ModuleManifestStr ref;
+        if (!str.has_value()) {
+            return ref;
+        }
+        ref.offset = static_cast<uint32_t>(strings_.size());
+        ref.size = static_cast<uint32_t>(str->size());
+        strings_.append(str.value());
+        return ref;
+    }
+
+    std::string &GetStrings()
+    {
+        return strings_;
+    }
+
+private:
+    std::string strings_;
+};
+
+template<typename T>
+void AppendRecords(std::string &buf, const std::vector<T> &records)
+{
+    buf.append(reinterpret_cast<const char *>(records.data()), records.size() * sizeof(T));
+}
+
+void BuildManifestBody(const ModulePackInfoMeta &meta, ModuleManifestHeader &header, std::string &body)
+{
+    ManifestWriter writer;
+    const std::optional<std::string> *fields[MANIFEST_HMP_NAME] = {
+        &meta.type, &meta.packageType, &meta.imageHash, &meta.name, &meta.version, &meta.apiVersion,
+        &meta.saSdkVersion, &meta.compatibleVersion, &meta.laneCode,
+    };
+    for (uint32_t i = 0; i < MANIFEST_HMP_NAME; i++) {
+        header.fields[i] = writer.AddString(*fields[i]);
+    }
+    const ModulePackageInfo &info = meta.moduleInfo;
+    header.fields[MANIFEST_HMP_NAME] = writer.AddString(info.hmpName);
+    header.fields[MANIFEST_HMP_VERSION] = writer.AddString(info.version);
+    header.fields[MANIFEST_HMP_DISPLAY_VERSION] = writer.AddString(info.displayVersion);
+    header.fields[MANIFEST_HMP_SA_SDK_VERSION] = writer.AddString(info.saSdkVersion);
+    header.fields[MANIFEST_HMP_TYPE] = writer.AddString(info.type);
+    header.hmpApiVersion = info.apiVersion;
+    header.isModuleInfoValid = meta.isModuleInfoValid ? 1 : 0;
+
+    std::vector<ModuleManifestModule> modules;
+    std::vector<ModuleManifestSa> sas;
+    std::vector<ModuleManifestBundle> bundles;
+    for (const auto &[name, moduleInfo] : info.moduleMap) {
+        ModuleManifestModule &module = modules.emplace_back();
+        module.name = writer.AddString(name);
+        module.saBegin = static_cast<uint32_t>(sas.size());
+        module.bundleBegin = static_cast<uint32_t>(bundles.size());
+        for (const auto &saInfo : moduleInfo.saInfoList) {
+            ModuleManifestSa &sa = sas.emplace_back();
+            sa.name = writer.AddString(saInfo.saName);
+            sa.saId = saInfo.saId;
+            sa.apiVersion = saInfo.version.apiVersion;
+            sa.versionCode = saInfo.version.versionCode;
+            sa.patchVersion = saInfo.version.patchVersion;
+        }
+        for (const auto &bundleInfo : moduleInfo.bundleInfoList) {
+            ModuleManifestBundle &bundle = bundles.emplace_back();
+            bundle.name = writer.AddString(bundleInfo.bundleName);
+            bundle.version = writer.AddString(bundleInfo.bundleVersion);
+        }
+        module.saNum = static_cast<uint32_t>(sas.size()) - module.saBegin;
+        module.bundleNum = static_cast<uint32_t>(bundles.size()) - module.bundleBegin;
+    }
+    header.moduleNum = static_cast<uint32_t>(modules.size());
+    header.saNum = static_cast<uint32_t>(sas.size());
+    header.bundleNum = static_cast<uint32_t>(bundles.size());
+    std::string &strings = writer.GetStrings();
+    strings.resize((strings.size() + MANIFEST_ALIGN - 1) / MANIFEST_ALIGN * MANIFEST_ALIGN, '\0');
+    header.stringsSize = static_cast<uint32_t>(strings.size());
+
+    AppendRecords(body, modules);
+    AppendRecords(body, sas);
+    AppendRecords(body, bundles);
+    body.append(strings);
+}
+}
+
+bool SaveModuleManifest(const std::string &manifestPath, const ModuleZipEntry &packInfo,
+    const ModulePackInfoMeta &meta)
+{
+    ModuleManifestHeader header;
+    std::string body;
+    BuildManifestBody(meta, header, body);
+    header.packInfoCrc = packInfo.crc;
+    header.packInfoSize = packInfo.uncompressedSize;
+    header.fileSize = static_cast<uint32_t>(sizeof(ModuleManifestHeader) + body.size());
+    header.checksum = Fnv1a(reinterpret_cast<const uint8_t *>(body.data()), body.size());
+    std::string manifest(reinterpret_cast<const char *>(&header), sizeof(header));
+    return SaveStringToFile(manifestPath, manifest + body);
+}
+
+bool GenerateModuleManifest(const std::string &zipPath)
+{
+    ModuleZipHelper helper(zipPath);
+    const ModuleZipEntry *packInfo = helper.IsValid() ? helper.FindEntry(PACK_INFO_NAME) : nullptr;
+    if (packInfo == nullptr) {
+        return false;
+    }
+    std::shared_ptr<const ModulePackInfoMeta> meta = ModulePackInfoCache::GetInstance().Get(zipPath);
+    if (meta == nullptr) {
+        return false;
+    }
+    return SaveModuleManifest(ExtractFilePath(zipPath) + PACK_INFO_BIN_NAME, *packInfo, *meta);
+}
+} // namespace SysInstaller
+} // namespace OHOS
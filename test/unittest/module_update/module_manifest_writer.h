@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef SYS_INSTALLER_MODULE_MANIFEST_WRITER_H
+#define SYS_INSTALLER_MODULE_MANIFEST_WRITER_H
+
+#include <string>
+
+#include "module_manifest.h"
+
+namespace OHOS {
+namespace SysInstaller {
+// test only writer of pack.info.bin, devices only load manifests built by gen_module_manifest.py
+bool SaveModuleManifest(const std::string &manifestPath, const ModuleZipEntry &packInfo,
+    const ModulePackInfoMeta &meta);
+// writes pack.info.bin next to zipPath from its current pack.info
+bool GenerateModuleManifest(const std::string &zipPath);
+} // namespace SysInstaller
+} // namespace OHOS
+#endif // SYS_INSTALLER_MODULE_MANIFEST_WRITER_H
@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "module_test_zip.h"
+
+namespace OHOS {
+namespace SysInstaller {
+bool WriteTestZip(const std::string &path, const std::vector<TestZipEntry> &entries, const char *comment)
+{
+    zipFile zip = zipOpen(path.c_str(), APPEND_STATUS_CREATE);
+    if (zip == nullptr) {
+        return false;
+    }
+    bool ret = true;
+    for (const auto &entry : entries) {
+        zip_fileinfo info {};
+        if (zipOpenNewFileInZip(zip, entry.name.c_str(), &info, nullptr, 0, nullptr, 0, nullptr, entry.method,
+            entry.method == 0 ? 0 : Z_DEFAULT_COMPRESSION) != ZIP_OK) {
+            ret = false;
+            break;
+        }
+        ret = zipWriteInFileInZip(zip, entry.content.data(), entry.content.size()) == ZIP_OK;
+        ret = zipCloseFileInZip(zip) == ZIP_OK && ret;
+        if (!ret) {
+            break;
+        }
+    }
+    return zipClose(zip, comment) == ZIP_OK && ret;
+}
+} // namespace SysInstaller
+} // namespace OHOS
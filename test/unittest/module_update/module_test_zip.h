@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef SYS_INSTALLER_MODULE_TEST_ZIP_H
+#define SYS_INSTALLER_MODULE_TEST_ZIP_H
+
+#include <string>
+#include <vector>
+
+#include "zip.h"
+
+namespace OHOS {
+namespace SysInstaller {
+struct TestZipEntry {
+    std::string name;
+    std::string content;
+    int method = Z_DEFLATED; // 0 stores the entry
+};
+
+// writes a fresh zip at path holding entries in order, replacing any existing file
+bool WriteTestZip(const std::string &path, const std::vector<TestZipEntry> &entries,
+    const char *comment = nullptr);
+} // namespace SysInstaller
+} // namespace OHOS
+#endif // SYS_INSTALLER_MODULE_TEST_ZIP_H
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "module_trace.h"
+
+using namespace testing::ext;
+using namespace std;
+
+namespace OHOS {
+namespace SysInstaller {
+namespace {
+const string TRACE_TEST_PATH = "/data/local/tmp/module_trace_test.json";
+
+ModuleTraceEvent MakeEvent(const char *name, const string &hmpName, int64_t startUs, int64_t durUs)
+{
+    ModuleTraceEvent event;
+    event.name = name;
+    event.hmpName = hmpName;
+    event.startUs = startUs;
+    event.durUs = durUs;
+    return event;
+}
+}
+
+class ModuleTraceTest : public testing::Test {
+public:
+    void TearDown() override
+    {
+        ModuleTrace::GetInstance().Disable();
+        ModuleTrace::GetInstance().Clear();
+        (void)unlink(TRACE_TEST_PATH.c_str());
+    }
+};
+
+/**
+ * @tc.name: DisabledSpan
+ * @tc.desc: a span records nothing until tracing is enabled
+ * @tc.type: FUNC
+ */
+HWTEST_F(ModuleTraceTest, DisabledSpan, TestSize.Level1)
+{
+    {
+        ModuleTraceSpan span(TRACE_SPAN_MOUNT, "hmp");
+    }
+    EXPECT_TRUE(ModuleTrace::GetInstance().GetEvents().empty());
+    ModuleTrace::GetInstance().Enable();
+    {
+        ModuleTraceSpan span(TRACE_SPAN_MOUNT, "hmp");
+    }
+    vector<ModuleTraceEvent> events = ModuleTrace::GetInstance().GetEvents();
+    ASSERT_EQ(events.size(), 1u);
+    EXPECT_EQ(events[0].name, TRACE_SPAN_MOUNT);
+    EXPECT_EQ(events[0].hmpName, "hmp");
+    EXPECT_GE(events[0].durUs, 0);
+}
+
+/**
+ * @tc.name: ExportAndCriticalPath
+ * @tc.desc: exported chrome trace loads back and the hmp finishing last is the critical path
+ * @tc.type: FUNC
+ */
+HWTEST_F(ModuleTraceTest, ExportAndCriticalPath, TestSize.Level1)
+{
+    ModuleTrace &trace = ModuleTrace::GetInstance();
+    trace.Record(MakeEvent(TRACE_SPAN_ACTIVATE, "fast", 100, 50));
+    trace.Record(MakeEvent(TRACE_SPAN_MOUNT, "fast", 120, 10));
+    trace.Record(MakeEvent(TRACE_SPAN_ACTIVATE, "slow", 110, 200));
+    trace.Record(MakeEvent(TRACE_SPAN_MOUNT, "slow", 250, 40));
+    trace.Record(MakeEvent(TRACE_SPAN_LOOP_CREATE, "slow", 130, 20));
+    ASSERT_TRUE(trace.Export(TRACE_TEST_PATH));
+
+    vector<ModuleTraceEvent> events;
+    ASSERT_TRUE(LoadModuleTrace(TRACE_TEST_PATH, events));
+    ASSERT_EQ(events.size(), 5u);
+    vector<ModuleTraceEvent> path = GetTraceCriticalPath(events);
+    ASSERT_EQ(path.size(), 3u);
+    EXPECT_EQ(path[0].hmpName, "slow");
+    EXPECT_EQ(path[0].EndUs(), 310);
+    EXPECT_EQ(path[1].name, TRACE_SPAN_LOOP_CREATE);
+    EXPECT_EQ(path[2].name, TRACE_SPAN_MOUNT);
+}
+} // namespace SysInstaller
+} // namespace OHOS
@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "directory_ex.h"
+#include "file_ex.h"
+#include "module_test_zip.h"
+#include "module_utils.h"
+
+using namespace testing::ext;
+using namespace std;
+
+namespace OHOS {
+namespace SysInstaller {
+namespace {
+constexpr const char *TEST_DIR = "/data/local/tmp/module_utils_test/";
+constexpr const char *TEST_ZIP_PATH = "/data/local/tmp/module_utils_test/test.hmp";
+constexpr const char *TEST_OUT_DIR = "/data/local/tmp/module_utils_test/out/";
+constexpr size_t TEST_ENTRY_NUM = 12;
+constexpr size_t TEST_ENTRY_UNIT = 4096;
+
+vector<TestZipEntry> MakeTestEntries()
+{
+    vector<TestZipEntry> entries;
+    for (size_t i = 0; i < TEST_ENTRY_NUM; i++) {
+        string name = (i % 3 == 0 ? "dir/sub/" : "") + string("file_") + to_string(i) + ".bin";
+        // mix stored and deflated entries, the stored ones take the direct read path
+        int method = i % 2 == 0 ? 0 : Z_DEFLATED;
+        entries.push_back({name, string(TEST_ENTRY_UNIT * (i + 1), static_cast<char>('a' + i)), method});
+    }
+    return entries;
+}
+}
+
+class ModuleUtilsTest : public testing::Test {
+public:
+    void SetUp() override
+    {
+        ForceRemoveDirectory(TEST_DIR);
+        ForceCreateDirectory(TEST_OUT_DIR);
+    }
+    void TearDown() override
+    {
+        ForceRemoveDirectory(TEST_DIR);
+    }
+};
+
+/**
+ * @tc.name: ExtractPackageParallel
+ * @tc.desc: every entry is extracted with its content and reported once, a failing callback aborts
+ * @tc.type: FUNC
+ */
+HWTEST_F(ModuleUtilsTest, ExtractPackageParallel, TestSize.Level1)
+{
+    vector<TestZipEntry> entries = MakeTestEntries();
+    ASSERT_TRUE(WriteTestZip(TEST_ZIP_PATH, entries));
+    atomic<size_t> extracted {0};
+    ASSERT_TRUE(ExtractPackageToDir(TEST_ZIP_PATH, TEST_OUT_DIR, [&extracted](const string &file) {
+        extracted++;
+        return FileExists(file);
+    }));
+    EXPECT_EQ(extracted.load(), entries.size());
+    for (const auto &entry : entries) {
+        string content;
+        ASSERT_TRUE(LoadStringFromFile(TEST_OUT_DIR + entry.name, content)) << entry.name;
+        EXPECT_EQ(content, entry.content) << entry.name;
+    }
+
+    ForceRemoveDirectory(TEST_OUT_DIR);
+    ForceCreateDirectory(TEST_OUT_DIR);
+    EXPECT_FALSE(ExtractPackageToDir(TEST_ZIP_PATH, TEST_OUT_DIR, [](const string &file) {
+        return file.find("file_3.bin") == string::npos;
+    }));
+}
+
+/**
+ * @tc.name: RejectTraversalEntry
+ * @tc.desc: entries escaping the output dir fail the whole extraction before anything is written
+ * @tc.type: FUNC
+ */
+HWTEST_F(ModuleUtilsTest, RejectTraversalEntry, TestSize.Level1)
+{
+    for (const char *name : {"../evil.bin", "dir/../../evil.bin", "/data/local/tmp/module_utils_test/evil.bin"}) {
+        vector<TestZipEntry> entries = MakeTestEntries();
+        entries.push_back({name, "evil"});
+        ASSERT_TRUE(WriteTestZip(TEST_ZIP_PATH, entries));
+        EXPECT_FALSE(ExtractPackageToDir(TEST_ZIP_PATH, TEST_OUT_DIR, nullptr)) << name;
+        EXPECT_FALSE(FileExists(string(TEST_DIR) + "evil.bin")) << name;
+        EXPECT_FALSE(FileExists(string(TEST_OUT_DIR) + "file_0.bin")) << name;
+    }
+}
+
+/**
+ * @tc.name: RejectNulEntry
+ * @tc.desc: an entry name with an embedded nul is rejected instead of being cut short
+ * @tc.type: FUNC
+ */
+HWTEST_F(ModuleUtilsTest, RejectNulEntry, TestSize.Level1)
+{
+    const string placeholder = "nulXname.bin";
+    vector<TestZipEntry> entries = MakeTestEntries();
+    entries.push_back({placeholder, "nul"});
+    ASSERT_TRUE(WriteTestZip(TEST_ZIP_PATH, entries));
+    // minizip takes c strings, patch the nul into both the local header and the central directory
+    string zip;
+    ASSERT_TRUE(LoadStringFromFile(TEST_ZIP_PATH, zip));
+    string patched = placeholder;
+    patched[placeholder.find('X')] = '\0';
+    size_t count = 0;
+    for (size_t pos = zip.find(placeholder); pos != string::npos; pos = zip.find(placeholder, pos + 1)) {
+        zip.replace(pos, placeholder.size(), patched);
+        count++;
+    }
+    ASSERT_EQ(count, 2u);
+    ASSERT_TRUE(SaveStringToFile(TEST_ZIP_PATH, zip));
+    EXPECT_FALSE(ExtractPackageToDir(TEST_ZIP_PATH, TEST_OUT_DIR, nullptr));
+    EXPECT_FALSE(FileExists(string(TEST_OUT_DIR) + "nul"));
+}
+} // namespace SysInstaller
+} // namespace OHOS
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "module_file.h"
+
+using namespace testing::ext;
+using namespace std;
+
+namespace OHOS {
+namespace SysInstaller {
+namespace {
+constexpr size_t BENCH_VERSION_NUM = 2000;
+constexpr size_t BENCH_ROUND = 5;
+constexpr size_t BENCH_PREFIX_NUM = 3;
+constexpr size_t BENCH_BUILD_NUM = 7;
+constexpr double NS_PER_US = 1000.0;
+
+int64_t NowNs()
+{
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// a few prefixes and close M.S.F.B numbers, so both the equal and the unequal paths get taken
+vector<string> MakeVersions()
+{
+    vector<string> versions;
+    versions.reserve(BENCH_VERSION_NUM);
+    for (size_t i = 0; i < BENCH_VERSION_NUM; i++) {
+        versions.emplace_back("bench-d0" + to_string(i % BENCH_PREFIX_NUM) + " 4." + to_string(10 + i % 2) + ".0." +
+            to_string(i % BENCH_BUILD_NUM));
+    }
+    return versions;
+}
+}
+
+class ModuleVersionPerfTest : public testing::Test {};
+
+/**
+ * @tc.name: HmpVersionCompare
+ * @tc.desc: pairwise comparison of synthetic versions, string vectors vs parsed HmpVersion
+ * @tc.type: FUNC
+ */
+HWTEST_F(ModuleVersionPerfTest, HmpVersionCompare, TestSize.Level1)
+{
+    vector<string> versions = MakeVersions();
+    size_t legacyTrue = 0;
+    int64_t start = NowNs();
+    for (size_t round = 0; round < BENCH_ROUND; round++) {
+        for (size_t i = 1; i < versions.size(); i++) {
+            vector<string> smallVersion {};
+            vector<string> bigVersion {};
+            ASSERT_TRUE(ParseVersion(versions[i - 1], " ", smallVersion));
+            ASSERT_TRUE(ParseVersion(versions[i], " ", bigVersion));
+            legacyTrue += CompareHmpVersion(smallVersion, bigVersion) ? 1 : 0;
+        }
+    }
+    double legacyUs = static_cast<double>(NowNs() - start) / NS_PER_US;
+
+    // parsing is paid once per ModuleFile, comparisons are then integer only
+    vector<HmpVersion> parsed(versions.size());
+    start = NowNs();
+    for (size_t i = 0; i < versions.size(); i++) {
+        ASSERT_TRUE(ParseHmpVersion(versions[i], ' ', parsed[i]));
+    }
+    double parseUs = static_cast<double>(NowNs() - start) / NS_PER_US;
+    size_t parsedTrue = 0;
+    start = NowNs();
+    for (size_t round = 0; round < BENCH_ROUND; round++) {
+        for (size_t i = 1; i < parsed.size(); i++) {
+            parsedTrue += CompareHmpVersion(parsed[i - 1], parsed[i]) ? 1 : 0;
+        }
+    }
+    double compareUs = static_cast<double>(NowNs() - start) / NS_PER_US;
+    EXPECT_EQ(legacyTrue, parsedTrue);
+    cout << "hmp version compare " << BENCH_ROUND * (versions.size() - 1) << " pairs: strings " << legacyUs <<
+        " us, parse once " << parseUs << " us + compare " << compareUs << " us" << endl;
+}
+} // namespace SysInstaller
+} // namespace OHOS
@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+#include "directory_ex.h"
+#include "file_ex.h"
+#include "module_test_zip.h"
+#include "module_zip_helper.h"
+
+using namespace testing::ext;
+using namespace std;
+
+namespace OHOS {
+namespace SysInstaller {
+namespace {
+constexpr const char *TEST_ZIP_DIR = "/data/local/tmp/module_zip_helper_test/";
+constexpr const char *TEST_ZIP_PATH = "/data/local/tmp/module_zip_helper_test/test.zip";
+constexpr const char *STORED_NAME = "stored.bin";
+constexpr const char *STORED_CONTENT = "stored entry content";
+constexpr const char *DEFLATED_NAME = "deflated.txt";
+constexpr const char *DEFLATED_CONTENT = "deflated entry content, deflated entry content, deflated entry content";
+}
+
+class ModuleZipHelperTest : public testing::Test {
+public:
+    void SetUp() override
+    {
+        ForceCreateDirectory(TEST_ZIP_DIR);
+        ASSERT_TRUE(WriteTestZip(TEST_ZIP_PATH, {{STORED_NAME, STORED_CONTENT, 0}, {DEFLATED_NAME, DEFLATED_CONTENT}},
+            "zip comment"));
+    }
+    void TearDown() override
+    {
+        ForceRemoveDirectory(TEST_ZIP_DIR);
+    }
+};
+
+/**
+ * @tc.name: CentralDirIndex
+ * @tc.desc: every entry is served from the index built at open
+ * @tc.type: FUNC
+ */
+HWTEST_F(ModuleZipHelperTest, CentralDirIndex, TestSize.Level1)
+{
+    ModuleZipHelper helper(TEST_ZIP_PATH);
+    ASSERT_TRUE(helper.IsValid());
+    uint32_t number = 0;
+    EXPECT_TRUE(helper.GetNumberOfEntry(number));
+    EXPECT_EQ(number, 2u);
+    EXPECT_EQ(helper.FindEntry("missing"), nullptr);
+    EXPECT_FALSE(helper.LocateFile("missing"));
+
+    const ModuleZipEntry *entry = helper.FindEntry(STORED_NAME);
+    ASSERT_NE(entry, nullptr);
+    EXPECT_EQ(entry->method, 0);
+    EXPECT_EQ(entry->uncompressedSize, strlen(STORED_CONTENT));
+
+    ASSERT_TRUE(helper.LocateFile(STORED_NAME));
+    uint32_t offset = 0;
+    ASSERT_TRUE(helper.GetFileOffset(offset));
+    string buf;
+    ASSERT_TRUE(helper.GetFileContent(buf));
+    EXPECT_EQ(buf, STORED_CONTENT);
+
+    ASSERT_TRUE(helper.LocateFile(DEFLATED_NAME));
+    uint32_t size = 0;
+    ASSERT_TRUE(helper.GetFileSize(size));
+    EXPECT_EQ(size, strlen(DEFLATED_CONTENT));
+    ASSERT_TRUE(helper.GetFileContent(buf));
+    EXPECT_EQ(buf, DEFLATED_CONTENT);
+}
+
+/**
+ * @tc.name: ReadIntoBuffer
+ * @tc.desc: entries are read or inflated into a caller buffer, short buffers are rejected
+ * @tc.type: FUNC
+ */
+HWTEST_F(ModuleZipHelperTest, ReadIntoBuffer, TestSize.Level1)
+{
+    ModuleZipHelper helper(TEST_ZIP_PATH);
+    ASSERT_TRUE(helper.LocateFile(DEFLATED_NAME));
+    vector<uint8_t> buffer(strlen(DEFLATED_CONTENT));
+    EXPECT_FALSE(helper.ReadFileContent(buffer.data(), buffer.size() - 1));
+    ASSERT_TRUE(helper.ReadFileContent(buffer.data(), buffer.size()));
+    EXPECT_EQ(string(buffer.begin(), buffer.end()), DEFLATED_CONTENT);
+
+    ASSERT_TRUE(helper.LocateFile(STORED_NAME));
+    buffer.assign(strlen(STORED_CONTENT), 0);
+    ASSERT_TRUE(helper.ReadFileContent(buffer.data(), buffer.size()));
+    EXPECT_EQ(string(buffer.begin(), buffer.end()), STORED_CONTENT);
+}
+
+/**
+ * @tc.name: StoredEntryCrc
+ * @tc.desc: a stored entry read past minizip is still checked against its crc
+ * @tc.type: FUNC
+ */
+HWTEST_F(ModuleZipHelperTest, StoredEntryCrc, TestSize.Level1)
+{
+    uint32_t offset = 0;
+    {
+        ModuleZipHelper helper(TEST_ZIP_PATH);
+        ASSERT_TRUE(helper.LocateFile(STORED_NAME));
+        ASSERT_TRUE(helper.GetFileOffset(offset));
+    }
+    int fd = open(TEST_ZIP_PATH, O_WRONLY | O_CLOEXEC);
+    ASSERT_GE(fd, 0);
+    EXPECT_EQ(pwrite(fd, "X", 1, offset), 1);
+    close(fd);
+
+    ModuleZipHelper helper(TEST_ZIP_PATH);
+    ASSERT_TRUE(helper.LocateFile(STORED_NAME));
+    vector<uint8_t> buffer(strlen(STORED_CONTENT));
+    EXPECT_FALSE(helper.ReadFileContent(buffer.data(), buffer.size()));
+    EXPECT_FALSE(helper.ReadFileChunks([](const uint8_t *, size_t) { return true; }, 4));
+}
+
+/**
+ * @tc.name: ReadFileChunks
+ * @tc.desc: entries are streamed through a bounded window, a failing consumer stops the read
+ * @tc.type: FUNC
+ */
+HWTEST_F(ModuleZipHelperTest, ReadFileChunks, TestSize.Level1)
+{
+    constexpr size_t window = 7;
+    ModuleZipHelper helper(TEST_ZIP_PATH);
+    for (const char *name : {STORED_NAME, DEFLATED_NAME}) {
+        ASSERT_TRUE(helper.LocateFile(name));
+        string content;
+        size_t maxChunk = 0;
+        ASSERT_TRUE(helper.ReadFileChunks([&content, &maxChunk](const uint8_t *data, size_t size) {
+            content.append(reinterpret_cast<const char *>(data), size);
+            maxChunk = max(maxChunk, size);
+            return true;
+        }, window));
+        EXPECT_EQ(content, strcmp(name, STORED_NAME) == 0 ? STORED_CONTENT : DEFLATED_CONTENT);
+        EXPECT_LE(maxChunk, window);
+        EXPECT_FALSE(helper.ReadFileChunks([](const uint8_t *, size_t) { return false; }, window));
+    }
+}
+
+/**
+ * @tc.name: InvalidZip
+ * @tc.desc: a file without central directory is rejected
+ * @tc.type: FUNC
+ */
+HWTEST_F(ModuleZipHelperTest, InvalidZip, TestSize.Level1)
+{
+    string path = string(TEST_ZIP_DIR) + "invalid.zip";
+    ASSERT_TRUE(SaveStringToFile(path, "not a zip file"));
+    ModuleZipHelper helper(path);
+    EXPECT_FALSE(helper.IsValid());
+    EXPECT_FALSE(helper.LocateFile(STORED_NAME));
+}
+} // namespace SysInstaller
+} // namespace OHOS
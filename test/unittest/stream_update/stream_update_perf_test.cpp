@@ -0,0 +1,416 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <condition_variable>
+#include <fcntl.h>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "isys_installer_callback.h"
+#include "ring_buffer.h"
+#include "securec.h"
+#include "stream_chunk_pool.h"
+#include "stream_log_sampler.h"
+#include "stream_queue.h"
+#include "stream_spsc_ring.h"
+#include "stream_status_manager.h"
+#include "stream_update.h"
+
+using namespace testing::ext;
+using namespace std;
+using namespace Updater;
+
+namespace OHOS {
+namespace SysInstaller {
+namespace {
+constexpr const char *FAKE_PARTITION_PATH = "/data/local/tmp/stream_update_fake_partition";
+constexpr uint64_t BENCH_STREAM_SIZE = 64 * 1024 * 1024;
+constexpr uint64_t FAKE_PARTITION_SYNC_SIZE = 8 * 1024 * 1024;
+constexpr double BYTES_PER_MIB = 1024.0 * 1024.0;
+constexpr uint64_t HANDOFF_STREAM_SIZE = 256 * 1024 * 1024;
+constexpr uint32_t HANDOFF_CHUNK_SIZE = 50 * 1024;
+constexpr uint32_t HANDOFF_CHUNK_NUM = 2;
+constexpr uint64_t LOG_BENCH_STREAM_SIZE = 4 * 1024 * HANDOFF_CHUNK_SIZE;
+constexpr uint32_t LATENCY_BENCH_NUM = 200000;
+
+struct StreamBenchConfig {
+    uint32_t slotSize;
+    uint32_t slotNum;
+};
+
+// writes every chunk to a plain file, fdatasync mimics the flush cost of a real partition
+class FakePartition {
+public:
+    bool Open()
+    {
+        fd_ = open(FAKE_PARTITION_PATH, O_CREAT | O_TRUNC | O_WRONLY | O_CLOEXEC, S_IRUSR | S_IWUSR);
+        return fd_ >= 0;
+    }
+
+    void Close()
+    {
+        if (fd_ >= 0) {
+            close(fd_);
+            fd_ = -1;
+        }
+        (void)unlink(FAKE_PARTITION_PATH);
+    }
+
+    UpdateResultCode Write(uint8_t *buffer, uint32_t len, uint32_t &dealLen)
+    {
+        if (pwrite(fd_, buffer, len, static_cast<off_t>(written_)) != static_cast<ssize_t>(len)) {
+            return STREAM_UPDATE_FAILURE;
+        }
+        written_ += len;
+        dealLen = len;
+        if (written_ % FAKE_PARTITION_SYNC_SIZE < len) {
+            (void)fdatasync(fd_);
+        }
+        if (written_ >= BENCH_STREAM_SIZE) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            done_ = true;
+            cv_.notify_all();
+        }
+        return STREAM_UPDATE_SUCCESS;
+    }
+
+    void WaitDone()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this] { return done_; });
+    }
+
+private:
+    int fd_ = -1;
+    uint64_t written_ = 0;
+    bool done_ = false;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+};
+
+// the apply stage hands every chunk to the sink, the run ends once the sink has seen streamSize bytes
+template<typename Sink>
+double RunPipeline(const StreamBenchConfig &config, uint64_t streamSize, Sink &sink)
+{
+    auto &processer = StreamInstallProcesser::GetInstance();
+    if (processer.SetSessionConfig(config.slotSize, config.slotNum) != 0) {
+        return -1.0;
+    }
+    processer.RegisterChunkHandler([&sink] (uint8_t *buffer, uint32_t len, uint32_t &dealLen) {
+        return sink.Write(buffer, len, dealLen);
+    });
+    std::vector<uint8_t> chunk(config.slotSize, 0x5a);
+    auto start = std::chrono::steady_clock::now();
+    if (processer.Start() != 0) {
+        processer.RegisterChunkHandler(nullptr);
+        return -1.0;
+    }
+    bool pushed = true;
+    for (uint64_t sent = 0; sent < streamSize && pushed; sent += config.slotSize) {
+        pushed = processer.ProcessStreamData(chunk.data(), config.slotSize) == 0;
+    }
+    if (pushed) {
+        sink.WaitDone();
+    }
+    auto cost = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    processer.Stop();
+    processer.RegisterChunkHandler(nullptr);
+    return (pushed && cost > 0) ? streamSize / BYTES_PER_MIB / cost : -1.0;
+}
+
+double RunStreamBench(const StreamBenchConfig &config)
+{
+    FakePartition partition;
+    if (!partition.Open()) {
+        return -1.0;
+    }
+    double mibPerSec = RunPipeline(config, BENCH_STREAM_SIZE, partition);
+    partition.Close();
+    return mibPerSec;
+}
+
+double ToMibPerSec(uint64_t bytes, std::chrono::steady_clock::time_point start)
+{
+    auto cost = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return cost > 0 ? bytes / BYTES_PER_MIB / cost : -1.0;
+}
+
+// the old path: staging copy, Push copies in, Pop copies out into a zeroed stack buffer
+double RunRingBufferHandoff()
+{
+    RingBuffer ringBuffer;
+    if (!ringBuffer.Init(HANDOFF_CHUNK_SIZE, HANDOFF_CHUNK_NUM)) {
+        return -1.0;
+    }
+    std::vector<uint8_t> source(HANDOFF_CHUNK_SIZE, 0x5a);
+    uint64_t received = 0;
+    auto start = std::chrono::steady_clock::now();
+    std::thread consumer([&ringBuffer, &received] {
+        while (received < HANDOFF_STREAM_SIZE) {
+            uint8_t buffer[HANDOFF_CHUNK_SIZE]{0};
+            uint32_t len = 0;
+            if (!ringBuffer.Pop(buffer, sizeof(buffer), len)) {
+                break;
+            }
+            received += len;
+        }
+    });
+    for (uint64_t sent = 0; sent < HANDOFF_STREAM_SIZE; sent += HANDOFF_CHUNK_SIZE) {
+        uint8_t tmpBuff[HANDOFF_CHUNK_SIZE]{0};
+        (void)memcpy_s(tmpBuff, sizeof(tmpBuff), source.data(), source.size());
+        if (!ringBuffer.Push(tmpBuff, HANDOFF_CHUNK_SIZE)) {
+            break;
+        }
+    }
+    consumer.join();
+    double mibPerSec = ToMibPerSec(received, start);
+    ringBuffer.Stop();
+    ringBuffer.Reset();
+    return mibPerSec;
+}
+
+// the pooled path: one copy into a page aligned chunk, the chunk itself is handed over
+double RunChunkPoolHandoff()
+{
+    StreamChunkPool pool;
+    if (!pool.Init(HANDOFF_CHUNK_SIZE, HANDOFF_CHUNK_NUM)) {
+        return -1.0;
+    }
+    std::vector<uint8_t> source(HANDOFF_CHUNK_SIZE, 0x5a);
+    uint64_t received = 0;
+    auto start = std::chrono::steady_clock::now();
+    std::thread consumer([&pool, &received] {
+        while (received < HANDOFF_STREAM_SIZE) {
+            StreamChunk *chunk = pool.Pop();
+            if (chunk == nullptr) {
+                break;
+            }
+            received += chunk->len;
+            pool.Release(chunk);
+        }
+    });
+    for (uint64_t sent = 0; sent < HANDOFF_STREAM_SIZE; sent += HANDOFF_CHUNK_SIZE) {
+        StreamChunk *chunk = pool.Acquire();
+        if (chunk == nullptr) {
+            break;
+        }
+        (void)memcpy_s(chunk->data, chunk->capacity, source.data(), source.size());
+        chunk->len = HANDOFF_CHUNK_SIZE;
+        pool.Submit(chunk);
+    }
+    consumer.join();
+    double mibPerSec = ToMibPerSec(received, start);
+    pool.Stop();
+    return mibPerSec;
+}
+
+uint64_t NowNs()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// every item carries its push time, the consumer accumulates push-to-pop delay
+template<typename Queue>
+double RunQueueHandoffLatency()
+{
+    Queue queue;
+    queue.Init(HANDOFF_CHUNK_NUM);
+    uint64_t totalNs = 0;
+    uint64_t received = 0;
+    std::thread consumer([&queue, &totalNs, &received] {
+        uint64_t pushNs = 0;
+        while (queue.Pop(pushNs)) {
+            totalNs += NowNs() - pushNs;
+            received++;
+        }
+    });
+    for (uint32_t i = 0; i < LATENCY_BENCH_NUM; i++) {
+        if (!queue.Push(NowNs())) {
+            break;
+        }
+    }
+    queue.Close();
+    consumer.join();
+    return received == LATENCY_BENCH_NUM ? static_cast<double>(totalNs) / received : -1.0;
+}
+
+double RunRingBufferHandoffLatency()
+{
+    RingBuffer ringBuffer;
+    if (!ringBuffer.Init(sizeof(uint64_t), HANDOFF_CHUNK_NUM)) {
+        return -1.0;
+    }
+    uint64_t totalNs = 0;
+    uint64_t received = 0;
+    std::thread consumer([&ringBuffer, &totalNs, &received] {
+        while (received < LATENCY_BENCH_NUM) {
+            uint64_t pushNs = 0;
+            uint32_t len = 0;
+            if (!ringBuffer.Pop(reinterpret_cast<uint8_t *>(&pushNs), sizeof(pushNs), len)) {
+                break;
+            }
+            totalNs += NowNs() - pushNs;
+            received++;
+        }
+    });
+    for (uint32_t i = 0; i < LATENCY_BENCH_NUM; i++) {
+        uint64_t pushNs = NowNs();
+        if (!ringBuffer.Push(reinterpret_cast<uint8_t *>(&pushNs), sizeof(pushNs))) {
+            break;
+        }
+    }
+    consumer.join();
+    ringBuffer.Stop();
+    ringBuffer.Reset();
+    return received == LATENCY_BENCH_NUM ? static_cast<double>(totalNs) / received : -1.0;
+}
+
+// takes chunks without touching storage so the cost of the pipeline itself, logging included, shows
+class CountingSink {
+public:
+    UpdateResultCode Write(uint8_t *buffer, uint32_t len, uint32_t &dealLen)
+    {
+        (void)buffer;
+        dealLen = len;
+        received_ += len;
+        if (received_ >= LOG_BENCH_STREAM_SIZE) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            done_ = true;
+            cv_.notify_all();
+        }
+        return STREAM_UPDATE_SUCCESS;
+    }
+
+    void WaitDone()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this] { return done_; });
+    }
+
+private:
+    uint64_t received_ = 0;
+    bool done_ = false;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+};
+
+double RunLoggingBench(uint32_t logIntervalMs)
+{
+    auto &processer = StreamInstallProcesser::GetInstance();
+    processer.SetApplyLogInterval(logIntervalMs);
+    CountingSink sink;
+    double mibPerSec = RunPipeline(StreamBenchConfig { HANDOFF_CHUNK_SIZE, HANDOFF_CHUNK_NUM }, LOG_BENCH_STREAM_SIZE,
+        sink);
+    processer.SetApplyLogInterval(STREAM_LOG_INTERVAL_MS);
+    return mibPerSec;
+}
+
+// stands in for the client, status and credit reports take the same path as in a real session
+class NoopInstallerCallback : public ISysInstallerCallback {
+public:
+    ErrCode OnUpgradeProgress(UpdateStatus updateStatus, int percent, const std::string &resultMsg) override
+    {
+        return 0;
+    }
+    ErrCode OnUpgradeDealLen(UpdateStatus updateStatus, int dealLen, const std::string &resultMsg) override
+    {
+        return 0;
+    }
+    ErrCode OnUpgradeFeatureStatus(const FeatureStatus &statusInfo) override
+    {
+        return 0;
+    }
+    ErrCode OnStreamCredits(uint32_t credits) override
+    {
+        return 0;
+    }
+    sptr<IRemoteObject> AsObject() override
+    {
+        return nullptr;
+    }
+};
+}
+
+class StreamUpdatePerfTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        statusManager_ = std::make_shared<StreamStatusManager>();
+        statusManager_->Init();
+        (void)statusManager_->SetUpdateCallback(sptr<NoopInstallerCallback>::MakeSptr());
+        StreamInstallProcesser::GetInstance().SetStatusManager(statusManager_);
+    }
+
+    void TearDown() override
+    {
+        (void)StreamInstallProcesser::GetInstance().SetSessionConfig(STREAM_DEFAULT_SLOT_SIZE,
+            STREAM_DEFAULT_SLOT_NUM);
+    }
+
+    std::shared_ptr<StreamStatusManager> statusManager_ {};
+};
+
+HWTEST_F(StreamUpdatePerfTest, SessionConfigSweep, TestSize.Level1)
+{
+    const std::vector<StreamBenchConfig> configs = {
+        { 50 * 1024, 2 }, { 256 * 1024, 4 }, { 1024 * 1024, 8 }, { 1024 * 1024, 16 },
+    };
+    for (const auto &config : configs) {
+        double mibPerSec = RunStreamBench(config);
+        EXPECT_GT(mibPerSec, 0);
+        std::cout << "slotSize " << config.slotSize << " slotNum " << config.slotNum <<
+            ": " << mibPerSec << " MiB/s" << std::endl;
+    }
+}
+
+HWTEST_F(StreamUpdatePerfTest, ChunkPoolThroughput, TestSize.Level1)
+{
+    double ringBufferMibPerSec = RunRingBufferHandoff();
+    double chunkPoolMibPerSec = RunChunkPoolHandoff();
+    EXPECT_GT(ringBufferMibPerSec, 0);
+    EXPECT_GT(chunkPoolMibPerSec, 0);
+    std::cout << "handoff without pool: " << ringBufferMibPerSec << " MiB/s, with pool: " <<
+        chunkPoolMibPerSec << " MiB/s" << std::endl;
+}
+
+HWTEST_F(StreamUpdatePerfTest, HandoffLatency, TestSize.Level1)
+{
+    double ringBufferNs = RunRingBufferHandoffLatency();
+    double queueNs = RunQueueHandoffLatency<StreamQueue<uint64_t>>();
+    double spscNs = RunQueueHandoffLatency<StreamSpscRing<uint64_t>>();
+    EXPECT_GT(ringBufferNs, 0);
+    EXPECT_GT(queueNs, 0);
+    EXPECT_GT(spscNs, 0);
+    std::cout << "handoff latency RingBuffer: " << ringBufferNs << " ns, StreamQueue: " << queueNs <<
+        " ns, StreamSpscRing: " << spscNs << " ns" << std::endl;
+}
+
+HWTEST_F(StreamUpdatePerfTest, LoggingOverhead, TestSize.Level1)
+{
+    double perChunkMibPerSec = RunLoggingBench(0);
+    double sampledMibPerSec = RunLoggingBench(STREAM_LOG_INTERVAL_MS);
+    EXPECT_GT(perChunkMibPerSec, 0);
+    EXPECT_GT(sampledMibPerSec, 0);
+    std::cout << "pipeline with a log line per chunk: " << perChunkMibPerSec << " MiB/s, sampled: " <<
+        sampledMibPerSec << " MiB/s" << std::endl;
+}
+} // namespace SysInstaller
+} // namespace OHOS
@@ -24,11 +24,16 @@
 #include <thread>
 #include <atomic>
 #include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <unistd.h>
+#include <vector>
 
 #include "gtest/gtest.h"
 
 using namespace testing::ext;
 using namespace std;
+using namespace Updater;
 
 namespace OHOS {
 namespace SysInstaller {
@@ -50,6 +55,429 @@ HWTEST_F(StreamInstallProcesserTest, ProcessStreamDataSuccess, TestSize.Level1)
 
     EXPECT_EQ(StreamInstallProcesser::GetInstance().ProcessStreamData(data, sizeof(data)), 0);
     StreamInstallProcesser::GetInstance().Stop();
+    // no session, the producer must fail instead of waiting for a chunk
+    EXPECT_EQ(StreamInstallProcesser::GetInstance().ProcessStreamData(data, sizeof(data)), -1);
+}
+
+HWTEST_F(StreamInstallProcesserTest, ProcessSharedStreamDataSuccess, TestSize.Level1)
+{
+    constexpr uint32_t slotSize = 1024;
+    constexpr uint32_t slotNum = 4;
+    sptr<Ashmem> ashmem = Ashmem::CreateAshmem("stream_update_test", slotSize * slotNum);
+    ASSERT_NE(ashmem, nullptr);
+    ASSERT_TRUE(ashmem->MapReadAndWriteAshmem());
+    uint8_t data[slotSize] = {0};
+    std::fill_n(data, sizeof(data), 0x55);
+    EXPECT_TRUE(ashmem->WriteToAshmem(data, sizeof(data), slotSize));
+
+    EXPECT_EQ(StreamInstallProcesser::GetInstance().ProcessSharedStreamData(1, sizeof(data)), -1);
+    EXPECT_EQ(StreamInstallProcesser::GetInstance().SetSharedMemory(ashmem, slotSize, slotNum), 0);
+    EXPECT_EQ(StreamInstallProcesser::GetInstance().Start(), 0);
+    EXPECT_EQ(StreamInstallProcesser::GetInstance().ProcessSharedStreamData(1, sizeof(data)), 0);
+    EXPECT_EQ(StreamInstallProcesser::GetInstance().ProcessSharedStreamData(slotNum, sizeof(data)), -1);
+    EXPECT_EQ(StreamInstallProcesser::GetInstance().ProcessSharedStreamData(0, slotSize + 1), -1);
+    StreamInstallProcesser::GetInstance().Stop();
+    StreamInstallProcesser::GetInstance().ReleaseSharedMemory();
+    ashmem->UnmapAshmem();
+    ashmem->CloseAshmem();
+}
+
+HWTEST_F(StreamInstallProcesserTest, SetSharedMemoryInvalidParam, TestSize.Level1)
+{
+    constexpr uint32_t slotSize = 1024;
+    sptr<Ashmem> ashmem = Ashmem::CreateAshmem("stream_update_test", slotSize);
+    ASSERT_NE(ashmem, nullptr);
+    EXPECT_EQ(StreamInstallProcesser::GetInstance().SetSharedMemory(nullptr, slotSize, 1), -1);
+    EXPECT_EQ(StreamInstallProcesser::GetInstance().SetSharedMemory(ashmem, slotSize, 2), -1);
+    EXPECT_EQ(StreamInstallProcesser::GetInstance().SetSharedMemory(ashmem, 0, 1), -1);
+    ashmem->CloseAshmem();
+}
+
+HWTEST_F(StreamInstallProcesserTest, ChunkPoolHandoffTest, TestSize.Level1)
+{
+    StreamChunkPool pool;
+    EXPECT_FALSE(pool.Init(0, 2));
+    ASSERT_TRUE(pool.Init(1024, 2));
+    StreamChunk *first = pool.Acquire();
+    StreamChunk *second = pool.Acquire();
+    ASSERT_NE(first, nullptr);
+    ASSERT_NE(second, nullptr);
+    EXPECT_NE(first->data, second->data);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(first->data) % static_cast<uintptr_t>(sysconf(_SC_PAGESIZE)), 0);
+    first->len = 1;
+    pool.Submit(first);
+    StreamChunk *popped = pool.Pop();
+    EXPECT_EQ(popped, first);
+    EXPECT_EQ(popped->len, 1);
+    pool.Release(popped);
+    pool.Release(second);
+    pool.Stop();
+    EXPECT_EQ(pool.Acquire(), nullptr);
+    EXPECT_EQ(pool.Pop(), nullptr);
+}
+
+HWTEST_F(StreamInstallProcesserTest, SpscRingTest, TestSize.Level1)
+{
+    StreamSpscRing<uint32_t> ring;
+    ring.Init(3);
+    uint32_t item = 0;
+    EXPECT_FALSE(ring.TryPop(item));
+    for (uint32_t i = 0; i < 3; i++) {
+        EXPECT_TRUE(ring.Push(i));
+    }
+    EXPECT_EQ(ring.Size(), 3);
+    EXPECT_TRUE(ring.TryPop(item));
+    EXPECT_EQ(item, 0);
+
+    constexpr uint32_t itemNum = 100000;
+    uint64_t sum = 0;
+    uint32_t popped = 0;
+    std::thread consumer([&ring, &sum, &popped] {
+        uint32_t value = 0;
+        while (ring.Pop(value)) {
+            sum += value;
+            popped++;
+        }
+    });
+    for (uint32_t i = 3; i < itemNum; i++) {
+        EXPECT_TRUE(ring.Push(i));
+    }
+    // closing lets the consumer drain what is left
+    ring.Close();
+    consumer.join();
+    EXPECT_EQ(popped, itemNum - 1);
+    EXPECT_EQ(sum, static_cast<uint64_t>(itemNum) * (itemNum - 1) / 2);
+    EXPECT_FALSE(ring.Push(0));
+
+    ring.Init(1);
+    EXPECT_TRUE(ring.Push(1));
+    std::thread producer([&ring] {
+        EXPECT_FALSE(ring.Push(2));
+    });
+    ring.Stop();
+    producer.join();
+    EXPECT_FALSE(ring.Pop(item));
+}
+
+HWTEST_F(StreamInstallProcesserTest, PipelineApplyTest, TestSize.Level1)
+{
+    constexpr uint32_t chunkNum = 3;
+    std::mutex mutex;
+    std::condition_variable cv;
+    uint32_t applied = 0;
+    std::vector<uint8_t> written;
+    auto &processer = StreamInstallProcesser::GetInstance();
+    processer.RegisterChunkHandler([&] (uint8_t *buffer, uint32_t len, uint32_t &dealLen) {
+        std::lock_guard<std::mutex> lock(mutex);
+        written.insert(written.end(), buffer, buffer + len);
+        dealLen = len;
+        applied++;
+        cv.notify_all();
+        return STREAM_UPDATE_SUCCESS;
+    });
+    EXPECT_CALL(*statusManager, UpdateCallback(testing::_, testing::_, testing::_)).Times(testing::AnyNumber());
+    std::vector<uint8_t> expected;
+    for (uint32_t i = 0; i < chunkNum; i++) {
+        expected.insert(expected.end(), 1024, static_cast<uint8_t>(i));
+    }
+    ASSERT_EQ(processer.Start(), 0);
+    for (uint32_t i = 0; i < chunkNum; i++) {
+        EXPECT_EQ(processer.ProcessStreamData(expected.data() + i * 1024, 1024), 0);
+    }
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        EXPECT_TRUE(cv.wait_for(lock, std::chrono::seconds(5), [&] { return applied == chunkNum; }));
+    }
+    StreamUpdateStats stats;
+    processer.GetStats(stats);
+    EXPECT_EQ(stats.bytesReceived, expected.size());
+    EXPECT_EQ(stats.bytesWritten, expected.size());
+    EXPECT_EQ(stats.chunksWritten, chunkNum);
+    processer.Stop();
+    processer.RegisterChunkHandler(nullptr);
+    EXPECT_EQ(written, expected);
+}
+
+HWTEST_F(StreamInstallProcesserTest, ProcessStreamDataBatchTest, TestSize.Level1)
+{
+    constexpr uint32_t slotSize = STREAM_MIN_SLOT_SIZE;
+    constexpr uint32_t slotNum = 4;
+    constexpr uint32_t batchSize = slotSize * 2 + 100;
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<uint32_t> chunkLens;
+    std::vector<uint8_t> written;
+    auto &processer = StreamInstallProcesser::GetInstance();
+    processer.RegisterChunkHandler([&] (uint8_t *buffer, uint32_t len, uint32_t &dealLen) {
+        std::lock_guard<std::mutex> lock(mutex);
+        written.insert(written.end(), buffer, buffer + len);
+        chunkLens.push_back(len);
+        dealLen = len;
+        cv.notify_all();
+        return STREAM_UPDATE_SUCCESS;
+    });
+    EXPECT_CALL(*statusManager, UpdateCallback(testing::_, testing::_, testing::_)).Times(testing::AnyNumber());
+    ASSERT_EQ(processer.SetSessionConfig(slotSize, slotNum), 0);
+    sptr<Ashmem> ashmem = Ashmem::CreateAshmem("stream_update_batch_test", slotSize * slotNum);
+    ASSERT_NE(ashmem, nullptr);
+    ASSERT_TRUE(ashmem->MapReadAndWriteAshmem());
+    EXPECT_EQ(processer.SetSharedMemory(ashmem, slotSize, slotNum), 0);
+    ASSERT_EQ(processer.Start(), 0);
+
+    std::vector<uint8_t> expected(batchSize);
+    for (uint32_t i = 0; i < batchSize; i++) {
+        expected[i] = static_cast<uint8_t>(i);
+    }
+    uint32_t accepted = 0;
+    EXPECT_EQ(processer.ProcessStreamDataBatch(expected.data(), batchSize, accepted), 0);
+    EXPECT_EQ(accepted, batchSize);
+    EXPECT_TRUE(ashmem->WriteToAshmem(expected.data(), batchSize, 0));
+    EXPECT_EQ(processer.ProcessSharedStreamDataBatch(batchSize, accepted), 0);
+    EXPECT_EQ(accepted, batchSize);
+    EXPECT_EQ(processer.ProcessSharedStreamDataBatch(slotSize * slotNum + 1, accepted), -1);
+    EXPECT_EQ(accepted, 0);
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        EXPECT_TRUE(cv.wait_for(lock, std::chrono::seconds(5), [&] { return written.size() == batchSize * 2; }));
+    }
+    processer.Stop();
+    processer.ReleaseSharedMemory();
+    ashmem->UnmapAshmem();
+    ashmem->CloseAshmem();
+    processer.RegisterChunkHandler(nullptr);
+    EXPECT_EQ(processer.SetSessionConfig(STREAM_DEFAULT_SLOT_SIZE, STREAM_DEFAULT_SLOT_NUM), 0);
+
+    const std::vector<uint32_t> expectLens = { slotSize, slotSize, 100, slotSize, slotSize, 100 };
+    EXPECT_EQ(chunkLens, expectLens);
+    std::vector<uint8_t> expectWritten = expected;
+    expectWritten.insert(expectWritten.end(), expected.begin(), expected.end());
+    EXPECT_EQ(written, expectWritten);
+}
+
+HWTEST_F(StreamInstallProcesserTest, TryProcessStreamDataTest, TestSize.Level1)
+{
+    constexpr uint32_t slotNum = 2;
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool isGateOpen = false;
+    bool hasCredits = false;
+    auto &processer = StreamInstallProcesser::GetInstance();
+    processer.RegisterChunkHandler([&] (uint8_t *buffer, uint32_t len, uint32_t &dealLen) {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [&] { return isGateOpen; });
+        dealLen = len;
+        return STREAM_UPDATE_SUCCESS;
+    });
+    EXPECT_CALL(*statusManager, UpdateCallback(testing::_, testing::_, testing::_)).Times(testing::AnyNumber());
+    EXPECT_CALL(*statusManager, CreditsCallback(testing::Gt(0))).Times(testing::AtLeast(1))
+        .WillRepeatedly([&] (uint32_t credits) {
+            std::lock_guard<std::mutex> lock(mutex);
+            hasCredits = true;
+            cv.notify_all();
+        });
+    ASSERT_EQ(processer.SetSessionConfig(STREAM_MIN_SLOT_SIZE, slotNum), 0);
+    ASSERT_EQ(processer.Start(), 0);
+    std::vector<uint8_t> data(STREAM_MIN_SLOT_SIZE, 0x5a);
+    StreamPushResult pushResult = StreamPushResult::STREAM_PUSH_WOULD_BLOCK;
+    uint32_t credits = 0;
+    for (uint32_t i = 0; i < slotNum; i++) {
+        EXPECT_EQ(processer.TryProcessStreamData(data.data(), data.size(), pushResult, credits), 0);
+        EXPECT_EQ(pushResult, StreamPushResult::STREAM_PUSH_ACCEPTED);
+        EXPECT_EQ(credits, slotNum - i - 1);
+    }
+    // both chunks are held by the blocked writer
+    EXPECT_EQ(processer.TryProcessStreamData(data.data(), data.size(), pushResult, credits), 0);
+    EXPECT_EQ(pushResult, StreamPushResult::STREAM_PUSH_WOULD_BLOCK);
+    EXPECT_EQ(credits, 0);
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        isGateOpen = true;
+        cv.notify_all();
+        EXPECT_TRUE(cv.wait_for(lock, std::chrono::seconds(5), [&] { return hasCredits; }));
+    }
+    EXPECT_EQ(processer.TryProcessStreamData(data.data(), data.size(), pushResult, credits), 0);
+    EXPECT_EQ(pushResult, StreamPushResult::STREAM_PUSH_ACCEPTED);
+    EXPECT_EQ(processer.TryProcessStreamData(nullptr, data.size(), pushResult, credits), -1);
+    processer.Stop();
+    EXPECT_EQ(processer.TryProcessStreamData(data.data(), data.size(), pushResult, credits), -1);
+    processer.RegisterChunkHandler(nullptr);
+    EXPECT_EQ(processer.SetSessionConfig(STREAM_DEFAULT_SLOT_SIZE, STREAM_DEFAULT_SLOT_NUM), 0);
+}
+
+HWTEST_F(StreamInstallProcesserTest, CheckpointJournalTest, TestSize.Level1)
+{
+    const std::string path = "/data/local/tmp/stream_update_checkpoint_test";
+    StreamCheckpointJournal journal(path);
+    journal.Clear();
+    StreamCheckpoint checkpoint;
+    EXPECT_FALSE(journal.Load(checkpoint));
+    StreamCheckpoint saved;
+    saved.committedOffset = 3 * 1024;
+    saved.slotSize = STREAM_DEFAULT_SLOT_SIZE;
+    ASSERT_TRUE(journal.Save(saved));
+    ASSERT_TRUE(journal.Load(checkpoint));
+    EXPECT_EQ(checkpoint.committedOffset, saved.committedOffset);
+    EXPECT_EQ(checkpoint.slotSize, saved.slotSize);
+    journal.Clear();
+    EXPECT_FALSE(journal.Load(checkpoint));
+}
+
+HWTEST_F(StreamInstallProcesserTest, ResumeTest, TestSize.Level1)
+{
+    constexpr uint32_t chunkSize = 1024;
+    std::mutex mutex;
+    std::condition_variable cv;
+    uint32_t applied = 0;
+    std::vector<uint8_t> written;
+    auto &processer = StreamInstallProcesser::GetInstance();
+    processer.SetCheckpointPath("/data/local/tmp/stream_update_checkpoint_test");
+    processer.RegisterChunkHandler([&] (uint8_t *buffer, uint32_t len, uint32_t &dealLen) {
+        std::lock_guard<std::mutex> lock(mutex);
+        written.insert(written.end(), buffer, buffer + len);
+        dealLen = len;
+        applied++;
+        cv.notify_all();
+        return STREAM_UPDATE_SUCCESS;
+    });
+    auto waitApplied = [&] (uint32_t num) {
+        std::unique_lock<std::mutex> lock(mutex);
+        return cv.wait_for(lock, std::chrono::seconds(5), [&] { return applied == num; });
+    };
+    EXPECT_CALL(*statusManager, UpdateCallback(testing::_, testing::_, testing::_)).Times(testing::AnyNumber());
+    std::vector<uint8_t> expected;
+    for (uint32_t i = 0; i < 2; i++) {
+        expected.insert(expected.end(), chunkSize, static_cast<uint8_t>(i));
+    }
+    expected.insert(expected.end(), chunkSize, 0x7f);
+    ASSERT_EQ(processer.Start(), 0);
+    for (uint32_t i = 0; i < 2; i++) {
+        EXPECT_EQ(processer.ProcessStreamData(expected.data() + i * chunkSize, chunkSize), 0);
+    }
+    EXPECT_TRUE(waitApplied(2));
+    processer.Stop();
+
+    uint64_t offset = 0;
+    ASSERT_EQ(processer.Resume(offset), 0);
+    EXPECT_EQ(offset, 2 * chunkSize);
+    EXPECT_EQ(processer.ProcessStreamData(expected.data() + offset, chunkSize), 0);
+    EXPECT_TRUE(waitApplied(3));
+    processer.Stop();
+    EXPECT_EQ(written, expected);
+
+    // a different session geometry can not continue the old parser state
+    EXPECT_EQ(processer.SetSessionConfig(STREAM_DEFAULT_SLOT_SIZE * 2, STREAM_DEFAULT_SLOT_NUM), 0);
+    ASSERT_EQ(processer.Resume(offset), 0);
+    EXPECT_EQ(offset, 0);
+    processer.Stop();
+    EXPECT_EQ(processer.SetSessionConfig(STREAM_DEFAULT_SLOT_SIZE, STREAM_DEFAULT_SLOT_NUM), 0);
+    processer.RegisterChunkHandler(nullptr);
+    processer.SetCheckpointPath(STREAM_CHECKPOINT_PATH);
+}
+
+HWTEST_F(StreamInstallProcesserTest, ResumeAfterRestartTest, TestSize.Level1)
+{
+    constexpr uint32_t chunkSize = 1024;
+    std::mutex mutex;
+    std::condition_variable cv;
+    uint32_t applied = 0;
+    std::vector<uint8_t> written;
+    auto &processer = StreamInstallProcesser::GetInstance();
+    processer.SetCheckpointPath("/data/local/tmp/stream_update_checkpoint_test");
+    processer.RegisterChunkHandler([&] (uint8_t *buffer, uint32_t len, uint32_t &dealLen) {
+        std::lock_guard<std::mutex> lock(mutex);
+        written.insert(written.end(), buffer, buffer + len);
+        dealLen = len;
+        applied++;
+        cv.notify_all();
+        return STREAM_UPDATE_SUCCESS;
+    });
+    auto waitApplied = [&] (uint32_t num) {
+        std::unique_lock<std::mutex> lock(mutex);
+        return cv.wait_for(lock, std::chrono::seconds(5), [&] { return applied == num; });
+    };
+    EXPECT_CALL(*statusManager, UpdateCallback(testing::_, testing::_, testing::_)).Times(testing::AnyNumber());
+    std::vector<uint8_t> expected(3 * chunkSize, 0x3c);
+    ASSERT_EQ(processer.Start(), 0);
+    for (uint32_t i = 0; i < 2; i++) {
+        EXPECT_EQ(processer.ProcessStreamData(expected.data() + i * chunkSize, chunkSize), 0);
+    }
+    EXPECT_TRUE(waitApplied(2));
+    processer.Stop();
+
+    // only the journal survives a restart of the service, without the parser state the stream starts over
+    processer.DropSessionState();
+    uint64_t offset = 1;
+    ASSERT_EQ(processer.Resume(offset), 0);
+    EXPECT_EQ(offset, 0);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        written.clear();
+    }
+    for (uint32_t i = 0; i < 3; i++) {
+        EXPECT_EQ(processer.ProcessStreamData(expected.data() + i * chunkSize, chunkSize), 0);
+    }
+    EXPECT_TRUE(waitApplied(5));
+    processer.Stop();
+    EXPECT_EQ(written, expected);
+    processer.RegisterChunkHandler(nullptr);
+    processer.SetCheckpointPath(STREAM_CHECKPOINT_PATH);
+}
+
+HWTEST_F(StreamInstallProcesserTest, StatsCollectorTest, TestSize.Level1)
+{
+    StreamUpdateStatsCollector collector;
+    collector.AddReceived(100);
+    collector.AddProducerBlocked(10);
+    collector.AddConsumerIdle(20);
+    collector.RecordApply(50, 500);
+    collector.RecordApply(50, 1500);
+    collector.RecordApply(50, 2000000);
+    StreamUpdateStats stats;
+    collector.GetStats(stats);
+    EXPECT_EQ(stats.bytesReceived, 100);
+    EXPECT_EQ(stats.bytesWritten, 150);
+    EXPECT_EQ(stats.chunksWritten, 3);
+    EXPECT_EQ(stats.producerBlockedUs, 10);
+    EXPECT_EQ(stats.consumerIdleUs, 20);
+    ASSERT_EQ(stats.latencyHistogram.size(), STREAM_LATENCY_BUCKET_NUM);
+    EXPECT_EQ(stats.latencyBucketBoundsUs.size(), STREAM_LATENCY_BUCKET_NUM - 1);
+    EXPECT_EQ(stats.latencyHistogram[0], 1);
+    EXPECT_EQ(stats.latencyHistogram[1], 1);
+    EXPECT_EQ(stats.latencyHistogram[STREAM_LATENCY_BUCKET_NUM - 1], 1);
+    collector.Reset();
+    collector.GetStats(stats);
+    EXPECT_EQ(stats.bytesReceived, 0);
+    EXPECT_EQ(stats.latencyHistogram[0], 0);
+}
+
+HWTEST_F(StreamInstallProcesserTest, LogSamplerTest, TestSize.Level1)
+{
+    StreamLogSampler quietSampler("quiet");
+    EXPECT_FALSE(quietSampler.OnChunk(100));
+    EXPECT_FALSE(quietSampler.OnChunk(100));
+    EXPECT_EQ(quietSampler.GetTotalChunks(), 2);
+    quietSampler.Flush();
+    EXPECT_EQ(quietSampler.GetTotalChunks(), 2);
+    quietSampler.Reset();
+    EXPECT_EQ(quietSampler.GetTotalChunks(), 0);
+
+    StreamLogSampler busySampler("busy", 0);
+    EXPECT_TRUE(busySampler.OnChunk(100));
+    EXPECT_EQ(busySampler.GetTotalChunks(), 1);
+}
+
+HWTEST_F(StreamInstallProcesserTest, SessionConfigInvalid, TestSize.Level1)
+{
+    auto &processer = StreamInstallProcesser::GetInstance();
+    EXPECT_EQ(processer.SetSessionConfig(STREAM_MIN_SLOT_SIZE - 1, STREAM_DEFAULT_SLOT_NUM), -1);
+    EXPECT_EQ(processer.SetSessionConfig(STREAM_MAX_SLOT_SIZE + 1, STREAM_DEFAULT_SLOT_NUM), -1);
+    EXPECT_EQ(processer.SetSessionConfig(STREAM_DEFAULT_SLOT_SIZE, STREAM_MIN_SLOT_NUM - 1), -1);
+    EXPECT_EQ(processer.SetSessionConfig(STREAM_DEFAULT_SLOT_SIZE, STREAM_MAX_SLOT_NUM + 1), -1);
+    EXPECT_EQ(processer.SetSessionConfig(STREAM_MAX_SLOT_SIZE, STREAM_MAX_SLOT_NUM), -1);
+    EXPECT_EQ(processer.SetSessionConfig(1024 * 1024, 8), 0);
+    EXPECT_EQ(processer.GetSlotSize(), 1024 * 1024);
+    EXPECT_EQ(processer.GetSlotNum(), 8);
+    EXPECT_EQ(processer.SetSessionConfig(STREAM_DEFAULT_SLOT_SIZE, STREAM_DEFAULT_SLOT_NUM), 0);
 }
 
 HWTEST_F(StreamInstallProcesserTest, UpdateResultTest, TestSize.Level1)
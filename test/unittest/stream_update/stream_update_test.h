@@ -28,6 +28,7 @@ class MockStatusManager : public StreamStatusManager {
 public:
     MOCK_METHOD(void, UpdateCallback, (UpdateStatus updateStatus, int dealLen,
         const std::string &resultMsg), (override));
+    MOCK_METHOD(void, CreditsCallback, (uint32_t credits), (override));
 };
 
 class StreamInstallProcesserTest : public ::testing::Test {
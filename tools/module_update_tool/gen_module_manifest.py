@@ -0,0 +1,264 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+# Copyright (c) 2025 Huawei Device Co., Ltd.
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+Build time generator of pack.info.bin for preinstalled hmp packages.
+The layout mirrors services/module_update/util/include/module_manifest.h.
+Only pack.info files the device parses without error are compiled, anything
+else fails the build so the hmp is shipped without its manifest target.
+"""
+
+import os
+import re
+import sys
+import json
+import struct
+import zipfile
+import argparse
+
+PACK_INFO_NAME = "pack.info"
+MANIFEST_MAGIC = 0x4D504D48
+MANIFEST_VERSION = 1
+MANIFEST_NO_STR = 0xFFFFFFFF
+MANIFEST_ALIGN = 4
+MANIFEST_FIELD_NUM = 14
+FNV_OFFSET_BASIS = 2166136261
+FNV_PRIME = 16777619
+
+HMP_TRAIN_TYPE = "moduleTrain"
+HMP_APP_TYPE = "APP"
+HMP_SA_TYPE = "systemAbility"
+HMP_SA_TYPE_OLD = "SYSTEM ability"
+HMP_MIX_TYPE = "combineType"
+
+# device byte order, all supported targets are little endian
+HEADER_FORMAT = "<IHHIIIIIiIIII" + "II" * MANIFEST_FIELD_NUM
+MODULE_FORMAT = "<IIIIII"
+SA_FORMAT = "<IIiIII"
+BUNDLE_FORMAT = "<IIII"
+
+INT32_MAX = 0x7FFFFFFF
+UINT32_MAX = 0xFFFFFFFF
+DEC_NUMBER = re.compile(r"^-?[0-9]+$")
+
+
+class UnsupportedPackInfo(Exception):
+    pass
+
+
+def reject_duplicate_keys(pairs):
+    keys = [key for key, _ in pairs]
+    if len(keys) != len(set(keys)):
+        raise UnsupportedPackInfo("duplicate json key")
+    return dict(pairs)
+
+
+def get_node(node, key):
+    return node.get(key) if isinstance(node, dict) else None
+
+
+def get_str(node, key):
+    value = get_node(node, key)
+    return value if isinstance(value, str) else None
+
+
+def require_str(node, key):
+    value = get_str(node, key)
+    if value is None:
+        raise UnsupportedPackInfo("missing %s" % key)
+    return value
+
+
+def to_int(text, low, high):
+    if not DEC_NUMBER.match(text):
+        raise UnsupportedPackInfo("invalid number %s" % text)
+    value = int(text)
+    if value < low or value > high:
+        raise UnsupportedPackInfo("number out of range %s" % text)
+    return value
+
+
+def split_str(text, sep):
+    # same as c_utils SplitStr, tokens trimmed and empty ones dropped
+    return [token.strip(" ") for token in text.split(sep) if token.strip(" ")]
+
+
+def children(node):
+    if node is None:
+        return []
+    if isinstance(node, list):
+        return node
+    if isinstance(node, dict):
+        return list(node.values())
+    raise UnsupportedPackInfo("not a container")
+
+
+def parse_sa_list(package):
+    sa_list = []
+    for sa_info in children(get_node(package, "saList")):
+        if not isinstance(sa_info, str):
+            raise UnsupportedPackInfo("invalid sa info")
+        sa_vec = split_str(sa_info, " ")
+        if len(sa_vec) != 3:
+            raise UnsupportedPackInfo("invalid sa info %s" % sa_info)
+        version_vec = split_str(sa_vec[2], ".")
+        if len(version_vec) != 3:
+            raise UnsupportedPackInfo("invalid sa version %s" % sa_vec[2])
+        versions = [to_int(item, 0, UINT32_MAX) for item in version_vec]
+        sa_list.append((sa_vec[0], to_int(sa_vec[1], -INT32_MAX - 1, INT32_MAX), versions))
+    return sa_list
+
+
+def parse_bundle_list(package):
+    bundle_list = get_node(package, "bundleList")
+    if bundle_list is None:
+        return []
+    # the device iterates the keys, an array or plain value has none
+    if not isinstance(bundle_list, dict):
+        raise UnsupportedPackInfo("invalid bundle list")
+    bundles = []
+    for bundle_info in bundle_list.keys():
+        bundle_vec = split_str(bundle_info, " ")
+        if len(bundle_vec) != 2:
+            raise UnsupportedPackInfo("invalid bundle info %s" % bundle_info)
+        bundles.append((bundle_vec[0], bundle_vec[1]))
+    return bundles
+
+
+def parse_module_info(root):
+    info = {"type": require_str(root, "type"), "saSdkVersion": None, "apiVersion": -1, "modules": []}
+    package = get_node(root, "package")
+    info["hmpName"] = require_str(package, "name")
+    info["version"] = require_str(package, "version")
+    info["displayVersion"] = require_str(package, "displayVersion")
+    if info["type"] not in (HMP_SA_TYPE, HMP_SA_TYPE_OLD):
+        info["apiVersion"] = to_int(require_str(package, "apiVersion"), -INT32_MAX - 1, INT32_MAX)
+    elif info["type"] != HMP_APP_TYPE:
+        require_str(package, "saSdkVersion")
+
+    modules = info["modules"]
+    if info["type"] == HMP_TRAIN_TYPE:
+        for module_info in children(get_node(package, "moduleInfo")):
+            module_package = get_node(module_info, "package")
+            modules.append((require_str(module_package, "name"), parse_sa_list(module_package),
+                            parse_bundle_list(module_package)))
+    else:
+        sa_list = []
+        bundle_list = []
+        if info["type"] in (HMP_SA_TYPE, HMP_SA_TYPE_OLD, HMP_MIX_TYPE):
+            sa_list = parse_sa_list(package)
+        if info["type"] in (HMP_APP_TYPE, HMP_MIX_TYPE):
+            bundle_list = parse_bundle_list(package)
+        modules.append((info["hmpName"], sa_list, bundle_list))
+    names = [module[0] for module in modules]
+    if len(names) != len(set(names)):
+        raise UnsupportedPackInfo("duplicate module name")
+    return info
+
+
+class StringTable(object):
+    def __init__(self):
+        self.data = bytearray()
+
+    def add(self, text):
+        if text is None:
+            return (MANIFEST_NO_STR, 0)
+        raw = text.encode("utf-8")
+        ref = (len(self.data), len(raw))
+        self.data += raw
+        return ref
+
+
+def fnv1a(data):
+    value = FNV_OFFSET_BASIS
+    for byte in data:
+        value = ((value ^ byte) * FNV_PRIME) & 0xFFFFFFFF
+    return value
+
+
+def build_manifest(root, pack_info_crc, pack_info_size):
+    info = parse_module_info(root)
+    package = get_node(root, "package")
+    lane_info = get_node(package, "laneInfo")
+    strings = StringTable()
+    # same order as ModuleManifestField
+    meta_fields = [
+        get_str(root, "type"), get_str(root, "packageType"), get_str(root, "imageHash"),
+        get_str(package, "name"), get_str(package, "version"), get_str(package, "apiVersion"),
+        get_str(package, "saSdkVersion"), get_str(lane_info, "compatibleVersion"), get_str(lane_info, "laneCode"),
+        info["hmpName"], info["version"], info["displayVersion"], info["saSdkVersion"], info["type"],
+    ]
+    # ModulePackageInfo fields are plain strings, an empty one is still written
+    fields = [strings.add(text) for text in meta_fields[:9]]
+    fields += [strings.add(text if text is not None else "") for text in meta_fields[9:]]
+
+    module_records = bytearray()
+    sa_records = bytearray()
+    bundle_records = bytearray()
+    sa_num = 0
+    bundle_num = 0
+    for name, sa_list, bundle_list in info["modules"]:
+        name_ref = strings.add(name)
+        for sa_name, sa_id, versions in sa_list:
+            sa_records += struct.pack(SA_FORMAT, *strings.add(sa_name), sa_id, *versions)
+        for bundle_name, bundle_version in bundle_list:
+            bundle_records += struct.pack(BUNDLE_FORMAT, *strings.add(bundle_name), *strings.add(bundle_version))
+        module_records += struct.pack(MODULE_FORMAT, *name_ref, sa_num, len(sa_list), bundle_num, len(bundle_list))
+        sa_num += len(sa_list)
+        bundle_num += len(bundle_list)
+    string_data = strings.data + b"\0" * (-len(strings.data) % MANIFEST_ALIGN)
+
+    body = bytes(module_records + sa_records + bundle_records + string_data)
+    header_size = struct.calcsize(HEADER_FORMAT)
+    flat_fields = [item for field in fields for item in field]
+    header = struct.pack(HEADER_FORMAT, MANIFEST_MAGIC, MANIFEST_VERSION, header_size, header_size + len(body),
+                         fnv1a(body), pack_info_crc, pack_info_size, 1, info["apiVersion"],
+                         len(info["modules"]), sa_num, bundle_num, len(string_data), *flat_fields)
+    return header + body
+
+
+def gen_manifest(zip_path, output_path):
+    with zipfile.ZipFile(zip_path) as hmp_zip:
+        entries = [entry for entry in hmp_zip.infolist() if entry.filename == PACK_INFO_NAME]
+        if len(entries) != 1:
+            raise UnsupportedPackInfo("expect one %s in %s" % (PACK_INFO_NAME, zip_path))
+        content = hmp_zip.read(entries[0])
+    # cJSON stops a string at a nul, python would keep the rest
+    if b"\\u0000" in content:
+        raise UnsupportedPackInfo("nul in %s" % PACK_INFO_NAME)
+    root = json.loads(content.decode("utf-8"), object_pairs_hook=reject_duplicate_keys)
+    manifest = build_manifest(root, entries[0].CRC, entries[0].file_size)
+    with open(output_path, "wb") as output:
+        output.write(manifest)
+
+
+def main(argv):
+    parser = argparse.ArgumentParser()
+    parser.add_argument("-z", "--zip_path", required=True, help="module_info.zip of the hmp")
+    parser.add_argument("-o", "--output", required=True, help="pack.info.bin to write")
+    args = parser.parse_args(argv[1:])
+    try:
+        gen_manifest(args.zip_path, args.output)
+    except (UnsupportedPackInfo, ValueError) as error:
+        print("failed to generate manifest of %s: %s" % (args.zip_path, error))
+        if os.path.exists(args.output):
+            os.remove(args.output)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
@@ -12,12 +12,15 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include <cstring>
 
 #include "isys_installer_callback_func.h"
 #include "isys_installer_callback.h"
+#include "module_constants.h"
 #include "module_update_kits.h"
 #include "module_error_code.h"
+#include "module_trace.h"
 #include "scope_guard.h"
 
 using namespace OHOS;
@@ -36,7 +39,9 @@ static const std::string HELP_MSG =
     "  update          : upgrade SA via hmp package\n"
     "  get_hmp_version : get hmp package version\n"
     "  get_result      : get hmp upgrade result\n"
-    "  show hmpname    : show upgrade sa info, if hmp name is null, show all\n";
+    "  show hmpname    : show upgrade sa info, if hmp name is null, show all\n"
+    "  trace [path]    : show the boot activation critical path, default path is " +
+    std::string(MODULE_TRACE_PATH) + "\n";
 
 static const std::string INSTALL_PARAM = "install";
 static const std::string UNINSTALL_PARAM = "uninstall";
@@ -44,6 +49,7 @@ static const std::string SHOW_INFO = "show";
 static const std::string UPDATE_PARAM = "update";
 static const std::string GET_HMP_VERSION = "get_hmp_version";
 static const std::string GET_RESULT = "get_result";
+static const std::string SHOW_TRACE = "trace";
 static const int32_t RET_FAILED = -1;
 
 static bool CheckParam(int argc)
@@ -170,11 +176,55 @@ static int ShowInfo(const std::string &hmpStr)
     return ret;
 }
 
+static int ShowTrace(const std::string &tracePath)
+{
+    std::vector<ModuleTraceEvent> events;
+    if (!LoadModuleTrace(tracePath, events)) {
+        printf("load trace %s failed\n", tracePath.c_str());
+        return RET_FAILED;
+    }
+    std::vector<ModuleTraceEvent> path = GetTraceCriticalPath(events);
+    if (path.empty()) {
+        printf("no activation found in %s\n", tracePath.c_str());
+        return RET_FAILED;
+    }
+    int64_t beginUs = path.front().startUs;
+    for (const auto &event : events) {
+        beginUs = std::min(beginUs, event.startUs);
+    }
+    std::vector<ModuleTraceEvent> activations;
+    for (const auto &event : events) {
+        if (event.name == TRACE_SPAN_ACTIVATE) {
+            activations.push_back(event);
+        }
+    }
+    std::sort(activations.begin(), activations.end(), [](const ModuleTraceEvent &a, const ModuleTraceEvent &b) {
+        return a.durUs > b.durUs;
+    });
+    printf("activations (us):\n");
+    for (const auto &event : activations) {
+        printf("  %-32s start:%-10lld dur:%lld\n", event.hmpName.c_str(),
+            static_cast<long long>(event.startUs - beginUs), static_cast<long long>(event.durUs));
+    }
+    const ModuleTraceEvent &critical = path.front();
+    printf("critical path: %s, ends at %lld us\n", critical.hmpName.c_str(),
+        static_cast<long long>(critical.EndUs() - beginUs));
+    for (size_t i = 1; i < path.size(); i++) {
+        printf("  %-16s start:%-10lld dur:%lld\n", path[i].name.c_str(),
+            static_cast<long long>(path[i].startUs - beginUs), static_cast<long long>(path[i].durUs));
+    }
+    return 0;
+}
+
 int main(int argc, char **argv)
 {
     if (!CheckParam(argc)) {
         return RET_FAILED;
     }
+    // works on local files, no need to reach the service
+    if (SHOW_TRACE.compare(argv[1]) == 0) {
+        return ShowTrace((argc != MIN_PARAM_NUM) ? argv[MIN_PARAM_NUM] : MODULE_TRACE_PATH);
+    }
 
     int ret = 0;
     OHOS::SysInstaller::ModuleUpdateKits& moduleUpdateKits = OHOS::SysInstaller::ModuleUpdateKits::GetInstance();